@@ -0,0 +1,14 @@
+%inline %{
+int func0() { return 0; }
+int func1(int a) { return a; }
+int func4(int a, int b, int c, int d) { return a + b + c + d; }
+
+class MyClass {
+public:
+    MyClass () {}
+    ~MyClass () {}
+    int method0 () { return 0; }
+    int method1 (int a) { return a; }
+    int method4 (int a, int b, int c, int d) { return a + b + c + d; }
+};
+%}
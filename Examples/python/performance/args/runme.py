@@ -0,0 +1,56 @@
+# Calls per second of functions and methods taking 0, 1 and 4 arguments,
+# wrapped with and without -fastcall.
+import sys
+import time
+import subprocess
+
+N = 2000000
+
+
+def rate(proc):
+    t1 = time.perf_counter()
+    proc()
+    t2 = time.perf_counter()
+    return N / (t2 - t1)
+
+
+def bench(mod):
+    x = mod.MyClass()
+    r = range(N)
+
+    def func0():
+        f = mod.func0
+        for i in r:
+            f()
+
+    def func1():
+        f = mod.func1
+        for i in r:
+            f(1)
+
+    def func4():
+        f = mod.func4
+        for i in r:
+            f(1, 2, 3, 4)
+
+    def method0():
+        for i in r:
+            x.method0()
+
+    def method1():
+        for i in r:
+            x.method1(1)
+
+    def method4():
+        for i in r:
+            x.method4(1, 2, 3, 4)
+
+    for proc in (func0, func1, func4, method0, method1, method4):
+        print("%-16s %-8s %12.0f calls/sec" % (mod.__name__, proc.__name__, rate(proc)))
+
+
+if len(sys.argv) > 1:
+    bench(__import__(sys.argv[1]))
+else:
+    for name in ("Simple_baseline", "Simple_fastcall"):
+        subprocess.call([sys.executable, "runme.py", name])
@@ -345,6 +345,7 @@ CPP_TEST_CASES += \
 	overload_bool \
 	overload_complicated \
 	overload_copy \
+	overload_dispatch \
 	overload_extend \
 	overload_method \
 	overload_numeric \
@@ -728,6 +729,7 @@ C_TEST_CASES += \
 	preproc_defined \
 	preproc_gcc_output \
 	preproc_include \
+	preproc_include_once \
 	preproc_line_file \
 	register_par \
 	ret_by_value \
@@ -757,6 +759,7 @@ MULTI_CPP_TEST_CASES += \
 # Custom tests - tests with additional commandline options
 wallkw.cpptest: SWIGOPT += -Wallkw
 preproc_include.ctest: SWIGOPT += -includeall
+preproc_include_once.ctest: SWIGOPT += -fastcpp
 
 # Allow modules to define temporarily failing tests.
 C_TEST_CASES := $(filter-out $(FAILING_C_TESTS),$(C_TEST_CASES))
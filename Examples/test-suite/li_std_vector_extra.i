@@ -147,3 +147,17 @@ std::string overloaded3(std::vector<int> *vi) { return "vector<int> *"; }
 std::string overloaded3(int i) { return "int"; }
 %}
 
+
+// Buffer protocol fast path and memoryview output
+%std_vector_memoryview(double)
+
+%inline %{
+std::vector<double> range_doubles(int n) {
+  std::vector<double> v;
+  for (int i = 0; i < n; ++i)
+    v.push_back(i);
+  return v;
+}
+double sum_doubles(const std::vector<double>& v) { return std::accumulate(v.begin(), v.end(), 0.0); }
+int sum_ints(const std::vector<int>& v) { return std::accumulate(v.begin(), v.end(), 0); }
+%}
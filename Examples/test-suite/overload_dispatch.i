@@ -0,0 +1,67 @@
+%module overload_dispatch
+
+// Overloads dispatched with the default mechanism (Cascade), with the
+// switch mechanism (Dispatcher) and with the dispatch cache (Cached) must select
+// the same functions. The runme also doubles as a benchmark of the dispatch
+// code.
+
+%inline %{
+class Shape {};
+class Circle : public Shape {};
+class Square : public Shape {};
+%}
+
+%define %overload_dispatch_class(NAME)
+%inline %{
+class NAME {
+public:
+  NAME() : id(0) {}
+  NAME(int) : id(1) {}
+  NAME(double) : id(2) {}
+  NAME(const char *) : id(3) {}
+  NAME(Shape *) : id(4) {}
+  NAME(int, int) : id(5) {}
+  NAME(Shape *, int) : id(6) {}
+  NAME(Shape *, double) : id(7) {}
+  int id;
+
+  int call() { return 0; }
+  int call(int) { return 1; }
+  int call(double) { return 2; }
+  int call(const char *) { return 3; }
+  int call(Circle *) { return 4; }
+  int call(Square *) { return 5; }
+  int call(Shape *) { return 6; }
+  int call(Shape *, int) { return 7; }
+  int call(Shape *, double) { return 8; }
+  int call(Shape *, const char *) { return 9; }
+  int call(Shape *, Shape *) { return 10; }
+  int call(Shape *, Shape *, int) { return 11; }
+  int call(Shape *, Shape *, Shape *) { return 12; }
+  int call(int, int, int, int = 0) { return 13; }
+
+  static int scall(int) { return 1; }
+  static int scall(Circle *) { return 4; }
+  static int scall(Shape *) { return 6; }
+  static int scall(Shape *, int) { return 7; }
+  static int scall(Shape *, Shape *) { return 10; }
+
+  // Only pointer typechecks, so the dispatch cache can be used
+  int pcall(Circle *) { return 4; }
+  int pcall(Square *) { return 5; }
+  int pcall(Shape *) { return 6; }
+  int pcall(Shape *, Shape *) { return 10; }
+  int pcall(Circle *, Circle *, Shape * = 0) { return 12; }
+};
+%}
+%enddef
+
+%overload_dispatch_class(Cascade)
+
+%switchdispatch;
+%overload_dispatch_class(Dispatcher)
+%clearswitchdispatch;
+
+%dispatchcache;
+%overload_dispatch_class(Cached)
+%cleardispatchcache;
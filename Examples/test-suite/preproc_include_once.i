@@ -0,0 +1,12 @@
+%module preproc_include_once
+
+// Files included again under another name: the include guard or #pragma once
+// must keep the %inline code from being emitted twice
+
+%include "preproc_include_once_guard.h"
+%include "errors/../preproc_include_once_guard.h"
+
+%include "preproc_include_once_pragma.h"
+%include "errors/../preproc_include_once_pragma.h"
+
+%constant int guarded_value = GUARDED_VALUE;
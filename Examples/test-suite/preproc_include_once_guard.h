@@ -0,0 +1,11 @@
+/* Included twice by preproc_include_once.i, under different names */
+#ifndef PREPROC_INCLUDE_ONCE_GUARD_H
+#define PREPROC_INCLUDE_ONCE_GUARD_H
+
+#define GUARDED_VALUE 10
+
+%inline %{
+int guarded_function(int a) { return a*2; }
+%}
+
+#endif
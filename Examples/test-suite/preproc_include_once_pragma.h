@@ -0,0 +1,6 @@
+/* Included twice by preproc_include_once.i, under different names */
+#pragma once
+
+%inline %{
+int once_function(int a) { return a*3; }
+%}
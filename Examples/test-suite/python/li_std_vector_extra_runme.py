@@ -181,3 +181,32 @@ for p in vcs[0:1]:
 for p in vcs[1:2]:
     if extractConstShort2(p) != 222:
         raise RuntimeError
+
+# Buffer protocol fast path and memoryview output
+import array
+import sys
+
+if sum_doubles(array.array("d", [1, 2, 3.5])) != 6.5:
+    raise RuntimeError("array of doubles not converted")
+if sum_ints(array.array("i", [1, 2, 3])) != 6:
+    raise RuntimeError("array of ints not converted")
+if sum_doubles(array.array("i", [1, 2, 3])) != 6:
+    raise RuntimeError("array of ints not converted to doubles")
+if sys.version_info[0] >= 3 and sum_ints(memoryview(array.array("i", [1, 2, 3, 4]))[::2]) != 4:
+    raise RuntimeError("non contiguous memoryview not converted")
+if overloaded1(array.array("i", [1])) != "vector<double>":
+    raise RuntimeError("array of ints overload")
+if overloaded2(array.array("d", [1])) != "vector<double>":
+    raise RuntimeError("array of doubles overload")
+
+rd = range_doubles(4)
+if sys.version_info[0:2] >= (3, 3):
+    if not isinstance(rd, memoryview) or rd.format != "d":
+        raise RuntimeError("memoryview expected, got {}".format(rd))
+    rd[0] = 10
+    if sum_doubles(rd) != 16:
+        raise RuntimeError("memoryview not converted")
+    if len(range_doubles(0)) != 0:
+        raise RuntimeError("empty memoryview")
+if list(rd) != [10 if sys.version_info[0:2] >= (3, 3) else 0, 1, 2, 3]:
+    raise RuntimeError("range_doubles")
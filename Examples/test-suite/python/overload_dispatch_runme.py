@@ -0,0 +1,85 @@
+import sys
+import timeit
+from overload_dispatch import *
+
+s = Shape()
+c = Circle()
+q = Square()
+
+calls = [
+    ((), 0),
+    ((1,), 1),
+    ((1.5,), 2),
+    (("hi",), 3),
+    ((c,), 4),
+    ((q,), 5),
+    ((s,), 6),
+    ((s, 1), 7),
+    ((c, 1.5), 8),
+    ((q, "hi"), 9),
+    ((s, c), 10),
+    ((c, q, 1), 11),
+    ((s, c, q), 12),
+    ((1, 2, 3), 13),
+    ((1, 2, 3, 4), 13),
+]
+
+pcalls = [
+    ((c,), 4),
+    ((q,), 5),
+    ((s,), 6),
+    ((None,), 4),
+    ((s, c), 10),
+    ((c, q), 10),
+    ((c, c), 12),
+    ((c, c, q), 12),
+    ((c, None, None), 12),
+]
+
+ctors = [
+    ((), 0),
+    ((1,), 1),
+    ((1.5,), 2),
+    (("hi",), 3),
+    ((c,), 4),
+    ((1, 2), 5),
+    ((s, 1), 6),
+    ((q, 1.5), 7),
+]
+
+for cls in (Cascade, Dispatcher, Cached):
+    for args, expected in ctors:
+        if cls(*args).id != expected:
+            raise RuntimeError("%s%s" % (cls.__name__, args))
+    obj = cls()
+    for args, expected in calls:
+        if obj.call(*args) != expected:
+            raise RuntimeError("%s.call%s" % (cls.__name__, args))
+    for i in range(2):
+        for args, expected in pcalls:
+            if obj.pcall(*args) != expected:
+                raise RuntimeError("%s.pcall%s" % (cls.__name__, args))
+    if cls.scall(1) != 1 or cls.scall(c) != 4 or cls.scall(q) != 6 or cls.scall(s, 1) != 7 or cls.scall(s, s) != 10:
+        raise RuntimeError("%s.scall" % cls.__name__)
+    try:
+        obj.call(s, 1, 2)
+        raise RuntimeError("%s.call(Shape, int, int) did not fail" % cls.__name__)
+    except TypeError:
+        pass
+
+# Run as "python overload_dispatch_runme.py benchmark" to compare the dispatch mechanisms
+if len(sys.argv) > 1 and sys.argv[1] == "benchmark":
+    def bench(obj):
+        for args, expected in calls:
+            obj.call(*args)
+
+    def pbench(obj):
+        for args, expected in pcalls:
+            for i in range(10):
+                obj.pcall(*args)
+
+    for cls in (Cascade, Dispatcher, Cached):
+        obj = cls()
+        print("%-8s call %.3fs pcall %.3fs" % (cls.__name__,
+              min(timeit.repeat(lambda: bench(obj), number=20000, repeat=5)),
+              min(timeit.repeat(lambda: pbench(obj), number=2000, repeat=5))))
@@ -0,0 +1,10 @@
+import preproc_include_once
+
+if preproc_include_once.guarded_function(10) != 20:
+    raise RuntimeError
+
+if preproc_include_once.once_function(10) != 30:
+    raise RuntimeError
+
+if preproc_include_once.guarded_value != 10:
+    raise RuntimeError
@@ -0,0 +1,90 @@
+from python_container_buffer import *
+import struct
+import sys
+
+def check(flag):
+    if not flag:
+        raise RuntimeError("Test failed")
+
+def view(obj):
+    try:
+        return memoryview(obj)
+    except TypeError:
+        # Proxy classes support the buffer protocol from Python 3.12 only, use the 'this' object before
+        return memoryview(obj.this)
+
+def items(m):
+    data = m.tobytes()
+    return list(struct.unpack("%d%s" % (len(data) // m.itemsize, m.format), data))
+
+v = DoubleVector([1.0, 2.0, 3.5])
+m = view(v)
+check(m.format == "d")
+check(m.itemsize == struct.calcsize("d"))
+check(m.shape == (3,))
+check(items(m) == [1.0, 2.0, 3.5])
+check(items(view(DoubleVector())) == [])
+
+i = IntVector([1, 2, 3])
+check(view(i).format == "i")
+check(items(view(i)) == [1, 2, 3])
+
+a = ShortArray4([1, 2, 3, 4])
+check(view(a).format == "h")
+check(items(view(a)) == [1, 2, 3, 4])
+
+# The buffer keeps the container alive
+m = view(DoubleVector([4.0, 5.0]))
+check(items(m) == [4.0, 5.0])
+
+if sys.version_info[0] >= 3:
+    # Writes go to the container storage
+    m = view(v)
+    m[1] = 20.0
+    check(v[1] == 20.0)
+    v[2] = 30.0
+    check(m[2] == 30.0)
+
+    # The vector can't be resized while the buffer is in use
+    def resizes(f):
+        try:
+            f()
+        except BufferError:
+            return False
+        return True
+    def del_item():
+        del v[0]
+    def del_slice():
+        del v[0:1]
+    def set_slice():
+        v[0:1] = [1.0, 2.0]
+    check(not resizes(lambda: v.push_back(1.0)))
+    check(not resizes(lambda: v.append(1.0)))
+    check(not resizes(lambda: v.resize(10)))
+    check(not resizes(lambda: v.reserve(100)))
+    check(not resizes(lambda: v.assign(2, 1.0)))
+    check(not resizes(lambda: v.swap(DoubleVector())))
+    check(not resizes(lambda: DoubleVector().swap(v)))
+    check(not resizes(v.clear))
+    check(not resizes(v.pop))
+    check(not resizes(del_item))
+    check(not resizes(del_slice))
+    check(not resizes(set_slice))
+    check(v.size() == 3)
+    m2 = view(v)
+    m.release()
+    check(not resizes(v.clear))
+    m2.release()
+    calls = exception_calls()
+    check(resizes(lambda: v.push_back(40.0)))
+    check(exception_calls() > calls)
+    check(v.size() == 4)
+    v.pop()
+
+    m = view(a)
+    m[0] = 10
+    check(a[0] == 10)
+    check(sum_array(a) == 19)
+
+    # A memoryview is converted to a vector without per item calls
+    check(sum_vector(view(v)) == 51.0)
@@ -0,0 +1,54 @@
+from python_director_bypass import *
+
+
+class Doubler(Callbacks):
+
+    def onValue(self, *args):
+        return 2 * sum(args)
+
+    def onAbstract(self, x):
+        return -x
+
+
+class Counter(Callbacks):
+
+    def __init__(self):
+        Callbacks.__init__(self)
+        self.count = 0
+
+    def onEvent(self):
+        self.count += 1
+
+    def onAbstract(self, x):
+        return x
+
+
+class DerivedCounter(Counter):
+
+    def onValue(self, x, y=0):
+        return Callbacks.onValue(self, x) + 100
+
+
+d = Doubler()
+if d.fire(3) != 6:
+    raise RuntimeError("overridden onValue not called")
+if d.events != 1:
+    raise RuntimeError("base onEvent not called")
+if d.fire2(3, 4) != 14:
+    raise RuntimeError("overridden overloaded onValue not called")
+if d.fireAbstract(5) != -5:
+    raise RuntimeError("pure virtual method not called")
+
+c = Counter()
+if c.fire(3) != 3:
+    raise RuntimeError("base onValue not called")
+if c.count != 1 or c.events != 0:
+    raise RuntimeError("overridden onEvent not called")
+if c.fire2(3, 4) != 7:
+    raise RuntimeError("base overloaded onValue not called")
+
+dc = DerivedCounter()
+if dc.fire(3) != 103:
+    raise RuntimeError("onValue overridden in a subclass not called")
+if dc.count != 1 or dc.events != 0:
+    raise RuntimeError("inherited onEvent override not called")
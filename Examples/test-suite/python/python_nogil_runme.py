@@ -0,0 +1,20 @@
+from python_nogil import *
+import sys
+
+def check(flag):
+    if not flag:
+        raise RuntimeError("Test failed")
+
+# PyGILState_Check() tells whether the GIL is held from Python 3.4
+if sys.version_info[0:2] >= (3, 4):
+    check(released() == 0)
+    check(held() == 1)
+
+    w = Worker()
+    check(w.work() == 0)
+    check(w.kept() == 1)
+
+    check(w.count == 2)
+    check(accessor_gil() == 1)
+    w.stats
+    check(accessor_gil() == 0)
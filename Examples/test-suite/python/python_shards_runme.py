@@ -0,0 +1,44 @@
+import python_shards
+
+
+class Override(python_shards.Base):
+
+    def value(self, i):
+        return 5 + i
+
+
+if python_shards.header_increment() != 1 or python_shards.header_increment() != 2:
+    raise RuntimeError("header_increment")
+
+b = python_shards.Base()
+if b.describe() != "Base:1":
+    raise RuntimeError("Base.describe: " + b.describe())
+if python_shards.Base.count() != 2:
+    raise RuntimeError("Base.count")
+
+d = python_shards.Derived()
+if d.describe() != "Derived:2":
+    raise RuntimeError("Derived.describe: " + d.describe())
+
+o = Override()
+if python_shards.call_value(o, 1) != 6:
+    raise RuntimeError("director call_value")
+if o.describe() != "Base:7":
+    raise RuntimeError("director describe: " + o.describe())
+
+if python_shards.cvar.global_value != 10:
+    raise RuntimeError("global_value")
+python_shards.cvar.global_value = 20
+if python_shards.cvar.global_value != 20:
+    raise RuntimeError("global_value set")
+if python_shards.cvar.global_name != "global":
+    raise RuntimeError("global_name")
+
+if python_shards.overloaded(1) != 1 or python_shards.overloaded(1, 2) != 3 or python_shards.overloaded("a") != "a!":
+    raise RuntimeError("overloaded")
+
+if python_shards.twice(4) != 8 or python_shards.add(2, 3) != 5:
+    raise RuntimeError("Space")
+
+if python_shards.inline_function() != 3:
+    raise RuntimeError("inline_function")
@@ -0,0 +1,13 @@
+import rename_pcre_enum
+
+# Foo_First and Foo_Second are renamed, Foo_Max is ignored
+if rename_pcre_enum.First == rename_pcre_enum.Second:
+    raise RuntimeError("Enum values should be different")
+if hasattr(rename_pcre_enum, "Max") or hasattr(rename_pcre_enum, "Foo_Max"):
+    raise RuntimeError("Foo_Max should be ignored")
+
+if rename_pcre_enum.MaxMax != 2:
+    raise RuntimeError("Wrong enum value")
+
+if rename_pcre_enum.red == rename_pcre_enum.blue:
+    raise RuntimeError("Enum values should be different")
@@ -0,0 +1,41 @@
+%module python_container_buffer
+
+// The checks for buffers in use don't replace a global %exception
+%{
+static int exception_count = 0;
+%}
+%exception {
+  ++exception_count;
+  $action
+}
+
+%include <std_vector.i>
+%include <std_array.i>
+
+%std_vector_buffer(double)
+%std_vector_buffer(int)
+%std_array_buffer(short, 4)
+
+%template(DoubleVector) std::vector<double>;
+%template(IntVector) std::vector<int>;
+%template(ShortArray4) std::array<short, 4>;
+
+%inline %{
+int exception_calls() {
+  return exception_count;
+}
+
+double sum_vector(const std::vector<double> &v) {
+  double sum = 0;
+  for (size_t i = 0; i < v.size(); ++i)
+    sum += v[i];
+  return sum;
+}
+
+int sum_array(const std::array<short, 4> &a) {
+  int sum = 0;
+  for (size_t i = 0; i < a.size(); ++i)
+    sum += a[i];
+  return sum;
+}
+%}
@@ -0,0 +1,21 @@
+%module(directors="1") python_director_bypass
+
+// Tested with -dirbypass, methods not overridden in Python call the C++ base directly
+
+%feature("director") Callbacks;
+
+%inline %{
+class Callbacks {
+public:
+  Callbacks() : events(0) {}
+  virtual ~Callbacks() {}
+  virtual int onValue(int x) { return x; }
+  virtual void onEvent() { ++events; }
+  virtual int onValue(int x, int y) { return x + y; }
+  virtual int onAbstract(int x) const = 0;
+  int fire(int x) { onEvent(); return onValue(x); }
+  int fire2(int x, int y) { return onValue(x, y); }
+  int fireAbstract(int x) const { return onAbstract(x); }
+  int events;
+};
+%}
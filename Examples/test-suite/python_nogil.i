@@ -0,0 +1,56 @@
+%module python_nogil
+
+// Release the GIL around the calls to the methods of Worker and to released(), but not
+// around Worker::kept() nor the getters of the Worker variables of non-class types
+%nogil Worker;
+%nogil released;
+%feature("gil", "keep") Worker::kept;
+%feature("gil", "keep_accessors") Worker;
+
+%{
+static int gil_held() {
+#if PY_VERSION_HEX >= 0x03040000
+  return PyGILState_Check();
+#else
+  return -1;
+#endif
+}
+
+static int accessor_gil_held = -1;
+%}
+
+// Record whether the getters hold the GIL from within their wrapped call
+%immutable Worker::count;
+%feature("action") Worker::count %{
+  accessor_gil_held = gil_held();
+  result = (int)arg1->count;
+%}
+
+%immutable Worker::stats;
+%feature("action") Worker::stats %{
+  accessor_gil_held = gil_held();
+  result = (Stats *)&arg1->stats;
+%}
+
+%inline %{
+int released() { return gil_held(); }
+int held() { return gil_held(); }
+
+int accessor_gil() {
+  int held = accessor_gil_held;
+  accessor_gil_held = -1;
+  return held;
+}
+
+struct Stats {
+  int calls;
+};
+
+struct Worker {
+  int count;
+  Stats stats;
+  Worker() : count(2) {}
+  int work() { return gil_held(); }
+  int kept() { return gil_held(); }
+};
+%}
@@ -0,0 +1,83 @@
+%module(directors="1") python_shards
+
+// Tested with -shards 3.  The code in %{ %} and %inline blocks is repeated in
+// each shard, so what it defines is either static or inline, or only defined
+// when SWIG_SHARD is not defined, that is in the main wrapper file.
+
+%include <std_string.i>
+
+%feature("director") Base;
+
+%{
+#include <string>
+
+int header_increment();
+
+#ifndef SWIG_SHARD
+int header_counter = 0;
+
+int header_increment() {
+  return ++header_counter;
+}
+#endif
+%}
+
+int header_increment();
+
+%inline %{
+class Base {
+public:
+  Base() {}
+  virtual ~Base() {}
+  virtual std::string name() const { return "Base"; }
+  virtual int value(int i) const;
+  std::string describe() const { return name() + ":" + (char)('0' + value(sv)); }
+  static int sv;
+  static int count();
+};
+
+struct Derived : Base {
+  std::string name() const { return "Derived"; }
+};
+
+extern int global_value;
+const char *const global_name = "global";
+static const int static_value = 3;
+
+int overloaded(int i);
+int overloaded(int i, int j);
+std::string overloaded(const std::string &s);
+
+inline int call_value(const Base &b, int i) {
+  return b.value(i);
+}
+
+namespace Space {
+  inline int twice(int i) { return 2*i; }
+  template<typename T> T add(T a, T b) { return a + b; }
+}
+
+inline int inline_function() { return static_value; }
+%}
+
+%{
+#ifndef SWIG_SHARD
+int Base::sv = 1;
+
+int Base::value(int i) const {
+  return i;
+}
+
+int Base::count() {
+  return ++sv;
+}
+
+int global_value = 10;
+
+int overloaded(int i) { return i; }
+int overloaded(int i, int j) { return i + j; }
+std::string overloaded(const std::string &s) { return s + "!"; }
+#endif
+%}
+
+%template(add) Space::add<int>;
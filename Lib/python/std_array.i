@@ -35,6 +35,12 @@
       throw std::invalid_argument("std::array object does not support item deletion");
     }
 
+    // Slice assignment only changes the items of a std::array in place, even while a buffer over it is in use
+    template <class T, size_t N>
+    inline void
+    container_check_resize(const std::array<T, N>* SWIGUNUSEDPARM(seq)) {
+    }
+
     // Only limited slicing is supported as std::array is fixed in size
     template <class T, size_t N, class Difference>
     inline std::array<T, N>*
@@ -89,3 +95,11 @@
 
 %include <std/std_array.i>
 
+
+/* Export the items of std::array<Type, N> through the buffer protocol, so that memoryview, NumPy
+   and the struct module access its storage directly, use before the %template for std::array<Type, N> */
+%define %std_array_buffer(Type, N)
+%fragment("StdContainerBuffer");
+%feature("python:bf_getbuffer", "swig::container_getbuffer< std::array< Type, N > >") std::array< Type, N >;
+%feature("python:bf_releasebuffer", "swig::container_releasebuffer< std::array< Type, N > >") std::array< Type, N >;
+%enddef
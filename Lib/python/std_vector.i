@@ -2,7 +2,123 @@
   Vectors
 */
 
-%fragment("StdVectorTraits","header",fragment="StdSequenceTraits")
+%fragment("StdVectorBuffer","header",fragment="StdBufferTraits")
+%{
+  namespace swig {
+    /* Copy a one dimensional contiguous buffer with items matching T into a new vector */
+    template <class T>
+    inline int asptr_vector_buffer(PyObject *obj, std::vector<T> **vec) {
+      const char *native = traits_buffer<T>::format();
+      if (!native || !PyObject_CheckBuffer(obj))
+	return SWIG_ERROR;
+      Py_buffer view;
+      if (PyObject_GetBuffer(obj, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) != 0) {
+	PyErr_Clear();
+	return SWIG_ERROR;
+      }
+      int res = SWIG_ERROR;
+      if (view.ndim == 1 && view.itemsize == (Py_ssize_t)sizeof(T) && buffer_format_matches(view.format, native)) {
+	if (vec) {
+	  const T *data = static_cast<const T *>(view.buf);
+	  *vec = new std::vector<T>(data, data + view.len / view.itemsize);
+	  res = SWIG_NEWOBJ;
+	} else {
+	  res = SWIG_OK;
+	}
+      }
+      PyBuffer_Release(&view);
+      return res;
+    }
+
+#if PY_VERSION_HEX >= 0x03030000
+    template <class T>
+    inline void *vector_data(std::vector<T> &vec) {
+      return &vec[0];
+    }
+
+    inline void *vector_data(std::vector<bool> &) {
+      return 0;
+    }
+
+    /* Python object owning the storage of a vector and exporting it through the buffer protocol */
+    struct SwigPyVectorBuffer {
+      PyObject_HEAD
+      void *buf;
+      Py_ssize_t shape;
+      Py_ssize_t itemsize;
+      const char *format;
+      void *vec;
+      void (*destroy)(void *vec);
+    };
+
+    template <class T>
+    inline void destroy_vector_buffer(void *vec) {
+      delete static_cast<std::vector<T> *>(vec);
+    }
+
+    inline int SwigPyVectorBuffer_getbuffer(PyObject *obj, Py_buffer *view, int flags) {
+      SwigPyVectorBuffer *self = (SwigPyVectorBuffer *)obj;
+      if (PyBuffer_FillInfo(view, obj, self->buf, self->shape * self->itemsize, 0, flags) != 0)
+	return -1;
+      view->itemsize = self->itemsize;
+      if ((flags & PyBUF_FORMAT) == PyBUF_FORMAT)
+	view->format = (char *)self->format;
+      if ((flags & PyBUF_ND) == PyBUF_ND)
+	view->shape = &self->shape;
+      return 0;
+    }
+
+    inline void SwigPyVectorBuffer_dealloc(PyObject *obj) {
+      SwigPyVectorBuffer *self = (SwigPyVectorBuffer *)obj;
+      PyTypeObject *type = Py_TYPE(obj);
+      self->destroy(self->vec);
+      type->tp_free(obj);
+      Py_DECREF(type);
+    }
+
+    inline PyTypeObject *SwigPyVectorBuffer_type() {
+      static PyType_Slot slots[] = {
+	{ Py_tp_dealloc, (void *)SwigPyVectorBuffer_dealloc },
+	{ Py_bf_getbuffer, (void *)SwigPyVectorBuffer_getbuffer },
+	{ 0, 0 }
+      };
+      static PyType_Spec spec = { "SwigPyVectorBuffer", sizeof(SwigPyVectorBuffer), 0, Py_TPFLAGS_DEFAULT, slots };
+      static PyTypeObject *type = (PyTypeObject *)PyType_FromSpec(&spec);
+      return type;
+    }
+#endif
+
+    /* Return a memoryview over the storage of a vector taking over the contents of vec,
+       or the usual tuple if the items can't be exported as they are */
+    template <class T>
+    inline PyObject *vector_memoryview(std::vector<T> &vec) {
+#if PY_VERSION_HEX >= 0x03030000
+      const char *format = traits_buffer<T>::format();
+      PyTypeObject *type = format ? SwigPyVectorBuffer_type() : 0;
+      if (type) {
+	SwigPyVectorBuffer *self = (SwigPyVectorBuffer *)PyType_GenericAlloc(type, 0);
+	if (!self)
+	  return NULL;
+	std::vector<T> *owned = new std::vector<T>();
+	owned->swap(vec);
+	static T empty;
+	self->buf = owned->empty() ? (void *)&empty : vector_data(*owned);
+	self->shape = (Py_ssize_t)owned->size();
+	self->itemsize = (Py_ssize_t)sizeof(T);
+	self->format = format;
+	self->vec = owned;
+	self->destroy = destroy_vector_buffer<T>;
+	PyObject *view = PyMemoryView_FromObject((PyObject *)self);
+	Py_DECREF((PyObject *)self);
+	return view;
+      }
+#endif
+      return traits_from<std::vector<T> >::from(vec);
+    }
+  }
+%}
+
+%fragment("StdVectorTraits","header",fragment="StdSequenceTraits",fragment="StdVectorBuffer")
 %{
   namespace swig {
     template <class T>
@@ -15,10 +131,15 @@
     template <class T>
     struct traits_asptr<std::vector<T> >  {
       static int asptr(PyObject *obj, std::vector<T> **vec) {
+	if (obj != Py_None && !SWIG_Python_GetSwigThis(obj)) {
+	  int res = asptr_vector_buffer<T>(obj, vec);
+	  if (SWIG_IsOK(res))
+	    return res;
+	}
 	return traits_asptr_stdseq<std::vector<T> >::asptr(obj, vec);
       }
     };
-    
+
     template <class T>
     struct traits_from<std::vector<T> > {
       static PyObject *from(const std::vector<T>& vec) {
@@ -32,3 +153,96 @@
 #define %swig_vector_methods_val(Type...) %swig_sequence_methods_val(Type);
 
 %include <std/std_vector.i>
+
+/* Return std::vector<Type> by value as a memoryview over the returned vector rather than
+   as a tuple, use after the %template for std::vector<Type> */
+%define %std_vector_memoryview(Type...)
+%typemap(out, fragment="StdVectorTraits") std::vector< Type > %{
+  $result = swig::vector_memoryview< Type >($1);
+%}
+%enddef
+
+/* The methods of std::vector<Type> that resize it, replaced by ones raising a BufferError rather
+   than resizing it while buffers over its storage are in use, as for a Python bytearray */
+%define %std_vector_buffer_resizes(Type...)
+%ignore std::vector< Type >::swap;
+%ignore std::vector< Type >::clear;
+%ignore std::vector< Type >::assign;
+%ignore std::vector< Type >::reserve;
+%ignore std::vector< Type >::resize;
+%ignore std::vector< Type >::push_back;
+%ignore std::vector< Type >::pop_back;
+%ignore std::vector< Type >::insert;
+%ignore std::vector< Type >::erase;
+%rename(swap) std::vector< Type >::swap_checked;
+%rename(clear) std::vector< Type >::clear_checked;
+%rename(assign) std::vector< Type >::assign_checked;
+%rename(reserve) std::vector< Type >::reserve_checked;
+%rename(resize) std::vector< Type >::resize_checked;
+%rename(push_back) std::vector< Type >::push_back_checked;
+%rename(pop_back) std::vector< Type >::pop_back_checked;
+%rename(insert) std::vector< Type >::insert_checked;
+%rename(erase) std::vector< Type >::erase_checked;
+%extend std::vector< Type > {
+  void swap_checked(std::vector< Type >& v) throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    swig::container_check_resize(&v);
+    $self->swap(v);
+  }
+  void clear_checked() throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    $self->clear();
+  }
+  void assign_checked(size_type n, const value_type& x) throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    $self->assign(n, x);
+  }
+  void reserve_checked(size_type n) throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    $self->reserve(n);
+  }
+  void resize_checked(size_type new_size) throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    $self->resize(new_size);
+  }
+  void resize_checked(size_type new_size, const value_type& x) throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    $self->resize(new_size, x);
+  }
+  void push_back_checked(const value_type& x) throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    $self->push_back(x);
+  }
+  void pop_back_checked() throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    $self->pop_back();
+  }
+#ifdef SWIG_EXPORT_ITERATOR_METHODS
+  iterator insert_checked(iterator pos, const value_type& x) throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    return $self->insert(pos, x);
+  }
+  void insert_checked(iterator pos, size_type n, const value_type& x) throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    $self->insert(pos, n, x);
+  }
+  iterator erase_checked(iterator pos) throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    return $self->erase(pos);
+  }
+  iterator erase_checked(iterator first, iterator last) throw (swig::container_exported_error) {
+    swig::container_check_resize($self);
+    return $self->erase(first, last);
+  }
+#endif
+}
+%enddef
+
+/* Export the items of std::vector<Type> through the buffer protocol, so that memoryview, NumPy
+   and the struct module access its storage directly, use before the %template for std::vector<Type> */
+%define %std_vector_buffer(Type...)
+%fragment("StdContainerBuffer");
+%feature("python:bf_getbuffer", "swig::container_getbuffer< std::vector< Type > >") std::vector< Type >;
+%feature("python:bf_releasebuffer", "swig::container_releasebuffer< std::vector< Type > >") std::vector< Type >;
+%std_vector_buffer_resizes(Type)
+%enddef
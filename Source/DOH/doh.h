@@ -103,9 +103,13 @@
 #define DohNewFileFromFile DOH_NAMESPACE(NewFileFromFile)
 #define DohNewFileFromFd   DOH_NAMESPACE(NewFileFromFd)
 #define DohFileErrorDisplay   DOH_NAMESPACE(FileErrorDisplay)
+#define DohKeepUnchangedFiles DOH_NAMESPACE(KeepUnchangedFiles)
+#define DohChangedFiles    DOH_NAMESPACE(ChangedFiles)
+#define DohUnreplacedFiles DOH_NAMESPACE(UnreplacedFiles)
 #define DohCopyto          DOH_NAMESPACE(Copyto)
 #define DohNewList         DOH_NAMESPACE(NewList)
 #define DohNewHash         DOH_NAMESPACE(NewHash)
+#define DohInternKey       DOH_NAMESPACE(InternKey)
 #define DohNewVoid         DOH_NAMESPACE(NewVoid)
 #define DohSplit           DOH_NAMESPACE(Split)
 #define DohSplitLines      DOH_NAMESPACE(SplitLines)
@@ -114,6 +118,10 @@
 #define DohObjMalloc       DOH_NAMESPACE(ObjMalloc)
 #define DohObjFree         DOH_NAMESPACE(ObjFree)
 #define DohMemoryDebug     DOH_NAMESPACE(MemoryDebug)
+#define DohMemoryAllocations DOH_NAMESPACE(MemoryAllocations)
+#define DohMemMalloc       DOH_NAMESPACE(MemMalloc)
+#define DohMemRealloc      DOH_NAMESPACE(MemRealloc)
+#define DohMemFree         DOH_NAMESPACE(MemFree)
 #define DohStringType      DOH_NAMESPACE(StringType)
 #define DohListType        DOH_NAMESPACE(ListType)
 #define DohHashType        DOH_NAMESPACE(HashType)
@@ -309,6 +317,9 @@ extern DOHFile *DohNewFileFromFd(int fd);
 extern void DohFileErrorDisplay(DOHString * filename);
 extern int DohCopyto(DOHFile * input, DOHFile * output);
 extern void DohCloseAllOpenFiles(void);
+extern int DohKeepUnchangedFiles(int on);
+extern DOHList *DohChangedFiles(void);
+extern int DohUnreplacedFiles(void);
 
 
 /* -----------------------------------------------------------------------------
@@ -323,6 +334,7 @@ extern void DohSortList(DOH *lo, int (*cmp) (const DOH *, const DOH *));
  * ----------------------------------------------------------------------------- */
 
 extern DOHHash *DohNewHash(void);
+extern DOHString *DohInternKey(const char *c);
 
 /* -----------------------------------------------------------------------------
  * Void
@@ -340,6 +352,7 @@ typedef union DohFuncPtr {
 } DohFuncPtr_t;
 
 extern void DohMemoryDebug(void);
+extern unsigned long DohMemoryAllocations(void);
 
 #ifndef DOH_LONG_NAMES
 /* Macros to invoke the above functions.  Includes the location of
@@ -415,6 +428,7 @@ extern void DohMemoryDebug(void);
 #define NewStringWithSize  DohNewStringWithSize
 #define NewStringf         DohNewStringf
 #define NewHash            DohNewHash
+#define InternKey          DohInternKey
 #define NewList            DohNewList
 #define NewFile            DohNewFile
 #define NewFileFromFile    DohNewFileFromFile
@@ -428,6 +442,9 @@ extern void DohMemoryDebug(void);
 #define Strchr             DohStrchr
 #define Copyto             DohCopyto
 #define CloseAllOpenFiles  DohCloseAllOpenFiles
+#define KeepUnchangedFiles DohKeepUnchangedFiles
+#define ChangedFiles       DohChangedFiles
+#define UnreplacedFiles    DohUnreplacedFiles
 #define Split              DohSplit
 #define SplitLines         DohSplitLines
 #define Setmark            DohSetmark
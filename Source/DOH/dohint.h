@@ -14,6 +14,34 @@
 #ifndef _DOHINT_H
 #define _DOHINT_H
 
+/* -----------------------------------------------------------------------------
+ * Memory allocation
+ *
+ * Memory owned by DOH objects is obtained from the size-class allocator in
+ * memory.c.  Each allocation records which kind of object it belongs to so that
+ * -debug-memory can show where the memory goes.  A source file sets
+ * DOH_MEMORY_TAG before including this header to choose its tag.
+ * ----------------------------------------------------------------------------- */
+
+#define DOH_MEM_OTHER     0	/* Anything else */
+#define DOH_MEM_POOL      1	/* Object header pools */
+#define DOH_MEM_STRING    2	/* String objects and their character data */
+#define DOH_MEM_LIST      3	/* List objects and their item arrays */
+#define DOH_MEM_HASH      4	/* Hash objects, slots and indexes */
+#define DOH_MEM_KEYS      5	/* Interned hash key table and arena */
+#define DOH_MEM_FILE      6	/* File objects */
+#define DOH_MEM_VOID      7	/* Void objects */
+#define DOH_MEM_FIO       8	/* Temporary formatting buffers */
+#define DOH_MEM_NTAGS     9
+
+#ifndef DOH_MEMORY_TAG
+#define DOH_MEMORY_TAG    DOH_MEM_OTHER
+#endif
+
+#define DohMalloc(size)        DohMemMalloc(size, DOH_MEMORY_TAG)
+#define DohRealloc(ptr, size)  DohMemRealloc(ptr, size, DOH_MEMORY_TAG)
+#define DohFree(ptr)           DohMemFree(ptr)
+
 #include "doh.h"
 
 #include <stdlib.h>
@@ -128,4 +156,8 @@ typedef struct {
 extern DOH *DohObjMalloc(DohObjInfo *type, void *data);	/* Allocate a DOH object */
 extern void DohObjFree(DOH *ptr);	/* Free a DOH object     */
 
+extern void *DohMemMalloc(size_t size, int tag);	/* Allocate object memory   */
+extern void *DohMemRealloc(void *ptr, size_t size, int tag);	/* Resize object memory     */
+extern void DohMemFree(void *ptr);	/* Release object memory    */
+
 #endif				/* DOHINT_H */
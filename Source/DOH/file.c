@@ -12,6 +12,7 @@
  *     ordinary FILE * or integer file descriptor.
  * ----------------------------------------------------------------------------- */
 
+#define DOH_MEMORY_TAG DOH_MEM_FILE
 #include "dohint.h"
 
 #ifdef DOH_INTFILE
@@ -23,8 +24,119 @@ typedef struct {
   FILE *filep;
   int fd;
   int closeondel;
+  DOHString *filename;		/* output file, NULL for other files */
+  DOHString *tmpname;		/* temporary file written instead when keeping unchanged files */
 } DohFile;
 
+static int keep_unchanged = 0;
+static DOHList *changed_files = 0;
+static int unreplaced_files = 0;
+
+/* -----------------------------------------------------------------------------
+ * DohKeepUnchangedFiles()
+ *
+ * Turn on or off writing output files to a temporary file first, which only
+ * replaces the output file when closed if the contents differ.  Unchanged files
+ * therefore keep their timestamp.  Returns the previous setting.
+ * ----------------------------------------------------------------------------- */
+
+int DohKeepUnchangedFiles(int on) {
+  int old = keep_unchanged;
+  keep_unchanged = on;
+  return old;
+}
+
+/* -----------------------------------------------------------------------------
+ * DohChangedFiles()
+ *
+ * List of the output files closed so far that were written, that is all of them
+ * unless keeping unchanged files.
+ * ----------------------------------------------------------------------------- */
+
+DOHList *DohChangedFiles(void) {
+  if (!changed_files)
+    changed_files = DohNewList();
+  return changed_files;
+}
+
+/* -----------------------------------------------------------------------------
+ * DohUnreplacedFiles()
+ *
+ * Number of output files closed so far that could not be replaced by the
+ * temporary file written instead, their contents being out of date.
+ * ----------------------------------------------------------------------------- */
+
+int DohUnreplacedFiles(void) {
+  return unreplaced_files;
+}
+
+/* -----------------------------------------------------------------------------
+ * same_contents()
+ *
+ * Returns 1 if the two files can be read and have the same contents.
+ * ----------------------------------------------------------------------------- */
+
+static int same_contents(const char *filename1, const char *filename2) {
+  char buffer1[8192];
+  char buffer2[8192];
+  int same = 0;
+  FILE *f1 = fopen(filename1, "rb");
+  FILE *f2 = f1 ? fopen(filename2, "rb") : 0;
+  if (f2) {
+    size_t n1, n2;
+    do {
+      n1 = fread(buffer1, 1, sizeof(buffer1), f1);
+      n2 = fread(buffer2, 1, sizeof(buffer2), f2);
+    } while (n1 == n2 && n1 > 0 && memcmp(buffer1, buffer2, n1) == 0);
+    same = n1 == 0 && n2 == 0 && !ferror(f1) && !ferror(f2);
+    fclose(f2);
+  }
+  if (f1)
+    fclose(f1);
+  return same;
+}
+
+/* -----------------------------------------------------------------------------
+ * close_file()
+ *
+ * Close the file.  An output file written to a temporary file replaces the
+ * output file at this point, unless their contents are the same.
+ * ----------------------------------------------------------------------------- */
+
+static void close_file(DohFile *f) {
+  if (f->filep) {
+    fclose(f->filep);
+    f->filep = 0;
+  }
+  if (f->tmpname) {
+    char *tmpname = Char(f->tmpname);
+    char *filename = Char(f->filename);
+    if (same_contents(tmpname, filename)) {
+      remove(tmpname);
+      Delete(f->filename);
+      f->filename = 0;
+    } else {
+#ifdef _WIN32
+      remove(filename);
+#endif
+      if (rename(tmpname, filename) != 0) {
+	Printf(stderr, "Unable to rename %s to %s: %s\n", tmpname, filename, strerror(errno));
+	remove(tmpname);
+	unreplaced_files++;
+	Delete(f->filename);
+	f->filename = 0;
+      }
+    }
+    Delete(f->tmpname);
+    f->tmpname = 0;
+  }
+  if (f->filename) {
+    Append(DohChangedFiles(), f->filename);
+    Delete(f->filename);
+    f->filename = 0;
+  }
+}
+
 /* -----------------------------------------------------------------------------
  * open_files_list_instance
  * open_files_list_add
@@ -83,12 +195,8 @@ void DohCloseAllOpenFiles() {
     assert(check == 1);
     (void)check;
     if (f->closeondel) {
-      if (f->filep) {
-	check = fclose(f->filep);
-	assert(check == 0);
-      }
+      close_file(f);
       f->closeondel = 0;
-      f->filep = 0;
     }
   }
   DohClear(all_open_files);
@@ -101,9 +209,7 @@ void DohCloseAllOpenFiles() {
 static void DelFile(DOH *fo) {
   DohFile *f = (DohFile *) ObjData(fo);
   if (f->closeondel) {
-    if (f->filep) {
-      fclose(f->filep);
-    }
+    close_file(f);
 #ifdef DOH_INTFILE
     if (f->fd) {
       close(f->fd);
@@ -277,22 +383,31 @@ static DohObjInfo DohFileType = {
  *
  * Create a new file from a given filename and mode.
  * If newfiles is non-zero, the filename is added to the list of new files.
+ * Such an output file is written to filename.swigtmp first if keeping
+ * unchanged files.
  * ----------------------------------------------------------------------------- */
 
 DOH *DohNewFile(DOHString *filename, const char *mode, DOHList *newfiles) {
   DohFile *f;
   DOH *obj;
   FILE *file;
-  char *filen;
+  DOHString *tmpname = 0;
 
-  filen = Char(filename);
-  file = fopen(filen, mode);
-  if (!file)
+  if (newfiles && keep_unchanged && *mode == 'w') {
+    tmpname = NewStringf("%s.swigtmp", filename);
+    file = fopen(Char(tmpname), mode);
+  } else {
+    file = fopen(Char(filename), mode);
+  }
+  if (!file) {
+    Delete(tmpname);
     return 0;
+  }
 
   f = (DohFile *) DohMalloc(sizeof(DohFile));
   if (!f) {
     fclose(file);
+    Delete(tmpname);
     return 0;
   }
   if (newfiles)
@@ -300,6 +415,8 @@ DOH *DohNewFile(DOHString *filename, const char *mode, DOHList *newfiles) {
   f->filep = file;
   f->fd = 0;
   f->closeondel = 1;
+  f->filename = newfiles ? NewString(filename) : 0;
+  f->tmpname = tmpname;
   obj = DohObjMalloc(&DohFileType, f);
   open_files_list_add(f);
   return obj;
@@ -319,6 +436,8 @@ DOH *DohNewFileFromFile(FILE *file) {
   f->filep = file;
   f->fd = 0;
   f->closeondel = 0;
+  f->filename = 0;
+  f->tmpname = 0;
   return DohObjMalloc(&DohFileType, f);
 }
 
@@ -336,6 +455,8 @@ DOH *DohNewFileFromFd(int fd) {
   f->filep = 0;
   f->fd = fd;
   f->closeondel = 0;
+  f->filename = 0;
+  f->tmpname = 0;
   return DohObjMalloc(&DohFileType, f);
 }
 
@@ -12,6 +12,7 @@
  *     formatted output, readline, and splitting.
  * ----------------------------------------------------------------------------- */
 
+#define DOH_MEMORY_TAG DOH_MEM_FIO
 #include "dohint.h"
 
 #define OBUFLEN  512
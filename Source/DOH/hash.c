@@ -11,94 +11,247 @@
  *     Implements a simple hash table object.
  * ----------------------------------------------------------------------------- */
 
+#define DOH_MEMORY_TAG DOH_MEM_HASH
 #include "dohint.h"
 
 extern DohObjInfo DohHashType;
 
-/* Hash node */
-typedef struct HashNode {
+/* Hash slot.  The slots of a hash table are stored inline in a single array in
+   insertion order.  Deleting an item leaves an empty slot (null key) behind,
+   these are reclaimed when the array next needs to grow. */
+typedef struct HashSlot {
   DOH *key;
   DOH *object;
-  struct HashNode *next;
-} HashNode;
+  int hashval;
+} HashSlot;
 
 /* Hash object */
 typedef struct Hash {
   DOH *file;
   int line;
-  HashNode **hashtable;
-  int hashsize;
-  int nitems;
+  HashSlot *slots;		/* Slots in insertion order */
+  int *index;			/* Open addressing index into slots, only for larger tables */
+  int nslots;			/* Number of slots in use, including empty ones */
+  int maxslots;			/* Number of slots allocated */
+  int indexsize;		/* Size of index, a power of 2 */
+  int indexshift;		/* 32 - log2(indexsize) */
+  int nitems;			/* Number of items */
 } Hash;
 
-/* Key interning structure */
+/* Key interning structure.  Interned keys live in an open addressing table
+   indexed by a precomputed hash of the C string.  The character data is
+   copied into a bump allocated arena as interned keys are never freed. */
 typedef struct KeyValue {
-  char *cstr;
+  unsigned int hashval;
+  int len;
+  const char *cstr;
   DOH *sstr;
-  struct KeyValue *left;
-  struct KeyValue *right;
 } KeyValue;
 
-static KeyValue *root = 0;
+#define KEY_TABLE_INIT_SIZE   1024
+#define KEY_ARENA_SIZE        65536
+
+static KeyValue *key_table = 0;
+static unsigned int key_table_size = 0;
+static unsigned int key_table_items = 0;
+static char *key_arena = 0;
+static int key_arena_avail = 0;
 static int max_expand = 1;
 
+/* Copy a key into the arena */
+static const char *key_arena_copy(const char *c, int len) {
+  char *r;
+  if (len + 1 > key_arena_avail) {
+    int size = (len + 1 > KEY_ARENA_SIZE) ? len + 1 : KEY_ARENA_SIZE;
+    key_arena = (char *) DohMemMalloc(size, DOH_MEM_KEYS);
+    assert(key_arena);
+    key_arena_avail = size;
+  }
+  r = key_arena;
+  memcpy(r, c, len);
+  r[len] = 0;
+  key_arena += len + 1;
+  key_arena_avail -= len + 1;
+  return r;
+}
+
+/* Compute the hash value and length of a key (FNV-1a) */
+static unsigned int key_hash(const char *c, int *len) {
+  const unsigned char *p = (const unsigned char *) c;
+  unsigned int h = 2166136261U;
+  while (*p) {
+    h ^= *p++;
+    h *= 16777619U;
+  }
+  *len = (int) (p - (const unsigned char *) c);
+  return h;
+}
+
+/* Double the size of the interned key table */
+static void key_table_grow(void) {
+  KeyValue *old_table = key_table;
+  unsigned int old_size = key_table_size;
+  unsigned int i;
+
+  key_table_size = old_size ? old_size * 2 : KEY_TABLE_INIT_SIZE;
+  key_table = (KeyValue *) DohMemMalloc(key_table_size * sizeof(KeyValue), DOH_MEM_KEYS);
+  assert(key_table);
+  memset(key_table, 0, key_table_size * sizeof(KeyValue));
+  for (i = 0; i < old_size; i++) {
+    if (old_table[i].cstr) {
+      unsigned int mask = key_table_size - 1;
+      unsigned int slot = old_table[i].hashval & mask;
+      while (key_table[slot].cstr)
+	slot = (slot + 1) & mask;
+      key_table[slot] = old_table[i];
+    }
+  }
+  DohFree(old_table);
+}
+
 /* Find or create a key in the interned key table */
 static DOH *find_key(DOH *doh_c) {
-  char *c = (char *) doh_c;
-  KeyValue *r, *s;
-  int d = 0;
-  /* OK, sure, we use a binary tree for maintaining interned
-     symbols.  Then we use their hash values for accessing secondary
-     hash tables. */
-  r = root;
-  s = 0;
-  while (r) {
-    s = r;
-    d = strcmp(r->cstr, c);
-    if (d == 0)
+  const char *c = (const char *) doh_c;
+  KeyValue *r;
+  unsigned int mask, slot;
+  int len;
+  unsigned int hv = key_hash(c, &len);
+
+  if (2 * (key_table_items + 1) > key_table_size)
+    key_table_grow();
+  mask = key_table_size - 1;
+  slot = hv & mask;
+  while (key_table[slot].cstr) {
+    r = &key_table[slot];
+    if ((r->hashval == hv) && (r->len == len) && (memcmp(r->cstr, c, len) == 0))
       return r->sstr;
-    if (d < 0)
-      r = r->left;
-    else
-      r = r->right;
+    slot = (slot + 1) & mask;
   }
   /*  fprintf(stderr,"Interning '%s'\n", c); */
-  r = (KeyValue *) DohMalloc(sizeof(KeyValue));
-  r->cstr = (char *) DohMalloc(strlen(c) + 1);
-  strcpy(r->cstr, c);
-  r->sstr = NewString(c);
+  r = &key_table[slot];
+  r->hashval = hv;
+  r->len = len;
+  r->cstr = key_arena_copy(c, len);
+  r->sstr = NewStringWithSize(r->cstr, len);
   DohIntern(r->sstr);
-  r->left = 0;
-  r->right = 0;
-  if (!s) {
-    root = r;
-  } else {
-    if (d < 0)
-      s->left = r;
-    else
-      s->right = r;
-  }
+  key_table_items++;
   return r->sstr;
 }
 
-#define HASH_INIT_SIZE   7
+/* -----------------------------------------------------------------------------
+ * DohInternKey()
+ *
+ * Returns the interned key String for a C string.  The returned object is never
+ * deleted, so callers making repeated lookups with the same attribute name can
+ * obtain it once and pass it to Getattr()/Setattr() to avoid interning the C
+ * string on every call.
+ * ----------------------------------------------------------------------------- */
 
-/* Create a new hash node */
-static HashNode *NewNode(DOH *k, void *obj) {
-  HashNode *hn = (HashNode *) DohMalloc(sizeof(HashNode));
-  hn->key = k;
-  Incref(hn->key);
-  hn->object = obj;
-  Incref(obj);
-  hn->next = 0;
-  return hn;
+DOH *DohInternKey(const char *c) {
+  return find_key((DOH *) c);
+}
+
+#define HASH_INIT_SLOTS   8
+#define HASH_LINEAR_MAX   16
+
+/* Compare a key against a key stored in the hash table */
+static int key_equal(DOH *k, DOH *nk) {
+  DohObjInfo *k_type = ((DohBase *) k)->type;
+  if (k_type != ((DohBase *) nk)->type)
+    return 0;
+  if (k_type->doh_equal)
+    return k_type->doh_equal(k, nk);
+  return k_type->doh_cmp(k, nk) == 0;
+}
+
+/* Initial index position for a hash value.  The hash values of Strings are
+   weak in the low bits, so scramble them (Fibonacci hashing) and use the top bits. */
+#define INDEX_POS(h, hv) ((unsigned int) (((unsigned int) (hv) * 2654435769U) >> (h)->indexshift))
+
+/* Add slot i to the index */
+static void index_insert(Hash *h, int i) {
+  unsigned int mask = (unsigned int) h->indexsize - 1;
+  unsigned int pos = INDEX_POS(h, h->slots[i].hashval);
+  while (h->index[pos] >= 0)
+    pos = (pos + 1) & mask;
+  h->index[pos] = i;
+}
+
+/* (Re)build the index so that it can hold all the allocated slots at a load factor of at most 1/2 */
+static void build_index(Hash *h) {
+  int i;
+  int size = 2 * HASH_LINEAR_MAX;
+  int shift = 27;
+  while (size < 2 * h->maxslots) {
+    size *= 2;
+    shift--;
+  }
+  DohFree(h->index);
+  h->index = (int *) DohMalloc(size * sizeof(int));
+  assert(h->index);
+  for (i = 0; i < size; i++)
+    h->index[i] = -1;
+  h->indexsize = size;
+  h->indexshift = shift;
+  for (i = 0; i < h->nslots; i++) {
+    if (h->slots[i].key)
+      index_insert(h, i);
+  }
+}
+
+/* Return the slot number holding key k (with hash value hv) or -1 if not found.
+   Small tables are scanned linearly, larger tables use the open addressing index. */
+static int find_slot(Hash *h, DOH *k, int hv) {
+  HashSlot *slot;
+  int i;
+  if (!h->index) {
+    for (i = 0; i < h->nslots; i++) {
+      slot = &h->slots[i];
+      if (slot->key && (slot->hashval == hv) && key_equal(k, slot->key))
+	return i;
+    }
+  } else {
+    unsigned int mask = (unsigned int) h->indexsize - 1;
+    unsigned int pos = INDEX_POS(h, hv);
+    while ((i = h->index[pos]) >= 0) {
+      slot = &h->slots[i];
+      if (slot->key && (slot->hashval == hv) && key_equal(k, slot->key))
+	return i;
+      pos = (pos + 1) & mask;
+    }
+  }
+  return -1;
+}
+
+/* Make room for another slot.  The array is compacted if it is mostly empty
+   slots left behind by deletions, otherwise it is doubled in size. */
+static void grow(Hash *h) {
+  if (h->nitems <= h->nslots / 2) {
+    int i, j = 0;
+    for (i = 0; i < h->nslots; i++) {
+      if (h->slots[i].key)
+	h->slots[j++] = h->slots[i];
+    }
+    h->nslots = j;
+  } else {
+    h->maxslots *= 2;
+    h->slots = (HashSlot *) DohRealloc(h->slots, h->maxslots * sizeof(HashSlot));
+    assert(h->slots);
+  }
+  if (h->index)
+    build_index(h);
 }
 
-/* Delete a hash node */
-static void DelNode(HashNode *hn) {
-  Delete(hn->key);
-  Delete(hn->object);
-  DohFree(hn);
+/* Initialize an empty hash table */
+static void init_hash(Hash *h, int maxslots) {
+  h->maxslots = maxslots < HASH_INIT_SLOTS ? HASH_INIT_SLOTS : maxslots;
+  h->slots = (HashSlot *) DohMalloc(h->maxslots * sizeof(HashSlot));
+  assert(h->slots);
+  h->index = 0;
+  h->indexsize = 0;
+  h->indexshift = 0;
+  h->nslots = 0;
+  h->nitems = 0;
 }
 
 /* -----------------------------------------------------------------------------
@@ -109,20 +262,19 @@ static void DelNode(HashNode *hn) {
 
 static void DelHash(DOH *ho) {
   Hash *h = (Hash *) ObjData(ho);
-  HashNode *n, *next;
   int i;
 
-  for (i = 0; i < h->hashsize; i++) {
-    n = h->hashtable[i];
-    while (n) {
-      next = n->next;
-      DelNode(n);
-      n = next;
+  for (i = 0; i < h->nslots; i++) {
+    if (h->slots[i].key) {
+      Delete(h->slots[i].key);
+      Delete(h->slots[i].object);
     }
   }
-  DohFree(h->hashtable);
-  h->hashtable = 0;
-  h->hashsize = 0;
+  DohFree(h->slots);
+  DohFree(h->index);
+  h->slots = 0;
+  h->index = 0;
+  h->nslots = 0;
   DohFree(h);
 }
 
@@ -134,66 +286,22 @@ static void DelHash(DOH *ho) {
 
 static void Hash_clear(DOH *ho) {
   Hash *h = (Hash *) ObjData(ho);
-  HashNode *n, *next;
   int i;
 
-  for (i = 0; i < h->hashsize; i++) {
-    n = h->hashtable[i];
-    while (n) {
-      next = n->next;
-      DelNode(n);
-      n = next;
+  for (i = 0; i < h->nslots; i++) {
+    if (h->slots[i].key) {
+      Delete(h->slots[i].key);
+      Delete(h->slots[i].object);
     }
-    h->hashtable[i] = 0;
   }
+  DohFree(h->index);
+  h->index = 0;
+  h->indexsize = 0;
+  h->indexshift = 0;
+  h->nslots = 0;
   h->nitems = 0;
 }
 
-/* resize the hash table */
-static void resize(Hash *h) {
-  HashNode *n, *next, **table;
-  int oldsize, newsize;
-  int i, p, hv;
-
-  if (h->nitems < 2 * h->hashsize)
-    return;
-
-  /* Too big. We have to rescale everything now */
-  oldsize = h->hashsize;
-
-  /* Calculate a new size */
-  newsize = 2 * oldsize + 1;
-  p = 3;
-  while (p < (newsize >> 1)) {
-    if (((newsize / p) * p) == newsize) {
-      newsize += 2;
-      p = 3;
-      continue;
-    }
-    p = p + 2;
-  }
-
-  table = (HashNode **) DohMalloc(newsize * sizeof(HashNode *));
-  for (i = 0; i < newsize; i++) {
-    table[i] = 0;
-  }
-
-  /* Walk down the old set of nodes and re-place */
-  h->hashsize = newsize;
-  for (i = 0; i < oldsize; i++) {
-    n = h->hashtable[i];
-    while (n) {
-      hv = Hashval(n->key) % newsize;
-      next = n->next;
-      n->next = table[hv];
-      table[hv] = n;
-      n = next;
-    }
-  }
-  DohFree(h->hashtable);
-  h->hashtable = table;
-}
-
 /* -----------------------------------------------------------------------------
  * Hash_setattr()
  *
@@ -202,8 +310,8 @@ static void resize(Hash *h) {
  * ----------------------------------------------------------------------------- */
 
 static int Hash_setattr(DOH *ho, DOH *k, DOH *obj) {
-  int hv;
-  HashNode *n, *prev;
+  int hv, i;
+  HashSlot *slot;
   Hash *h = (Hash *) ObjData(ho);
 
   if (!obj) {
@@ -215,33 +323,35 @@ static int Hash_setattr(DOH *ho, DOH *k, DOH *obj) {
     obj = NewString((char *) obj);
     Decref(obj);
   }
-  hv = (Hashval(k)) % h->hashsize;
-  n = h->hashtable[hv];
-  prev = 0;
-  while (n) {
-    if (Cmp(n->key, k) == 0) {
-      /* Node already exists.  Just replace its contents */
-      if (n->object == obj) {
-	/* Whoa. Same object.  Do nothing */
-	return 1;
-      }
-      Delete(n->object);
-      n->object = obj;
-      Incref(obj);
-      return 1;			/* Return 1 to indicate a replacement */
-    } else {
-      prev = n;
-      n = n->next;
+  hv = Hashval(k);
+  i = find_slot(h, k, hv);
+  if (i >= 0) {
+    /* Slot already exists.  Just replace its contents */
+    slot = &h->slots[i];
+    if (slot->object == obj) {
+      /* Whoa. Same object.  Do nothing */
+      return 1;
     }
+    Delete(slot->object);
+    slot->object = obj;
+    Incref(obj);
+    return 1;			/* Return 1 to indicate a replacement */
   }
   /* Add this to the table */
-  n = NewNode(k, obj);
-  if (prev)
-    prev->next = n;
-  else
-    h->hashtable[hv] = n;
+  if (h->nslots == h->maxslots)
+    grow(h);
+  slot = &h->slots[h->nslots];
+  slot->key = k;
+  Incref(k);
+  slot->object = obj;
+  Incref(obj);
+  slot->hashval = hv;
+  if (h->index)
+    index_insert(h, h->nslots);
+  h->nslots++;
   h->nitems++;
-  resize(h);
+  if (!h->index && (h->nslots > HASH_LINEAR_MAX))
+    build_index(h);
   return 0;
 }
 
@@ -250,32 +360,12 @@ static int Hash_setattr(DOH *ho, DOH *k, DOH *obj) {
  *
  * Get an attribute from the hash table. Returns 0 if it doesn't exist.
  * ----------------------------------------------------------------------------- */
-typedef int (*binop) (DOH *obj1, DOH *obj2);
-
 
-static DOH *Hash_getattr(DOH *h, DOH *k) {
-  DOH *obj = 0;
-  Hash *ho = (Hash *) ObjData(h);
+static DOH *Hash_getattr(DOH *ho, DOH *k) {
+  Hash *h = (Hash *) ObjData(ho);
   DOH *ko = DohCheck(k) ? k : find_key(k);
-  int hv = Hashval(ko) % ho->hashsize;
-  DohObjInfo *k_type = ((DohBase*)ko)->type;
-  HashNode *n = ho->hashtable[hv];
-  if (k_type->doh_equal) {
-    binop equal = k_type->doh_equal;
-    while (n) {
-      DohBase *nk = (DohBase *)n->key;
-      if ((k_type == nk->type) && equal(ko, nk)) obj = n->object;
-      n = n->next;
-    }
-  } else {
-    binop cmp = k_type->doh_cmp;
-    while (n) {
-      DohBase *nk = (DohBase *)n->key;
-      if ((k_type == nk->type) && (cmp(ko, nk) == 0)) obj = n->object;
-      n = n->next;
-    }
-  }
-  return obj;
+  int i = find_slot(h, ko, Hashval(ko));
+  return i >= 0 ? h->slots[i].object : 0;
 }
 
 /* -----------------------------------------------------------------------------
@@ -285,79 +375,90 @@ static DOH *Hash_getattr(DOH *h, DOH *k) {
  * ----------------------------------------------------------------------------- */
 
 static int Hash_delattr(DOH *ho, DOH *k) {
-  HashNode *n, *prev;
-  int hv;
+  HashSlot *slot;
+  int i;
   Hash *h = (Hash *) ObjData(ho);
 
   if (!DohCheck(k))
     k = find_key(k);
-  hv = Hashval(k) % h->hashsize;
-  n = h->hashtable[hv];
-  prev = 0;
-  while (n) {
-    if (Cmp(n->key, k) == 0) {
-      /* Found it, kill it */
-
-      if (prev) {
-	prev->next = n->next;
-      } else {
-	h->hashtable[hv] = n->next;
-      }
-      DelNode(n);
-      h->nitems--;
-      return 1;
-    }
-    prev = n;
-    n = n->next;
+  i = find_slot(h, k, Hashval(k));
+  if (i < 0)
+    return 0;
+
+  /* Found it, kill it.  The slot is left empty so that iterators and the index stay valid */
+  slot = &h->slots[i];
+  Delete(slot->key);
+  Delete(slot->object);
+  slot->key = 0;
+  slot->object = 0;
+  h->nitems--;
+  if (!h->index) {
+    /* Trailing empty slots can be reused straight away */
+    while (h->nslots > 0 && !h->slots[h->nslots - 1].key)
+      h->nslots--;
   }
-  return 0;
+  return 1;
+}
+
+/* Iteration visits items in insertion order.  _index holds the next slot to
+   look at, so deleting the item being iterated over is safe. */
+static DohIterator Hash_nextiter(DohIterator iter) {
+  Hash *h = (Hash *) ObjData(iter.object);
+  int i = iter._index;
+  while ((i < h->nslots) && !h->slots[i].key)
+    i++;
+  if (i >= h->nslots) {
+    iter.item = 0;
+    iter.key = 0;
+    iter._index = i;
+    return iter;
+  }
+  iter.key = h->slots[i].key;
+  iter.item = h->slots[i].object;
+  iter._index = i + 1;
+  return iter;
 }
 
 static DohIterator Hash_firstiter(DOH *ho) {
   DohIterator iter;
-  Hash *h = (Hash *) ObjData(ho);
   iter.object = ho;
   iter._current = 0;
   iter.item = 0;
   iter.key = 0;
-  iter._index = 0;		/* Index in hash table */
-  while ((iter._index < h->hashsize) && !h->hashtable[iter._index])
-    iter._index++;
+  iter._index = 0;
+  return Hash_nextiter(iter);
+}
 
-  if (iter._index >= h->hashsize) {
-    return iter;
-  }
-  iter._current = h->hashtable[iter._index];
-  iter.item = ((HashNode *) iter._current)->object;
-  iter.key = ((HashNode *) iter._current)->key;
+/* -----------------------------------------------------------------------------
+ * CopyHash()
+ *
+ * Make a copy of a hash table.  Note: this is a shallow copy.
+ * ----------------------------------------------------------------------------- */
 
-  /* Actually save the next slot in the hash.  This makes it possible to
-     delete the item being iterated over without trashing the universe */
-  iter._current = ((HashNode *) iter._current)->next;
-  return iter;
-}
+static DOH *CopyHash(DOH *ho) {
+  Hash *h, *nh;
+  int i;
 
-static DohIterator Hash_nextiter(DohIterator iter) {
-  Hash *h = (Hash *) ObjData(iter.object);
-  if (!iter._current) {
-    iter._index++;
-    while ((iter._index < h->hashsize) && !h->hashtable[iter._index]) {
-      iter._index++;
-    }
-    if (iter._index >= h->hashsize) {
-      iter.item = 0;
-      iter.key = 0;
-      iter._current = 0;
-      return iter;
+  h = (Hash *) ObjData(ho);
+  nh = (Hash *) DohMalloc(sizeof(Hash));
+  init_hash(nh, h->nitems);
+  nh->line = h->line;
+  nh->file = h->file;
+  if (nh->file)
+    Incref(nh->file);
+
+  for (i = 0; i < h->nslots; i++) {
+    if (h->slots[i].key) {
+      HashSlot *slot = &nh->slots[nh->nslots++];
+      *slot = h->slots[i];
+      Incref(slot->key);
+      Incref(slot->object);
     }
-    iter._current = h->hashtable[iter._index];
   }
-  iter.key = ((HashNode *) iter._current)->key;
-  iter.item = ((HashNode *) iter._current)->object;
-
-  /* Store the next node to iterator on */
-  iter._current = ((HashNode *) iter._current)->next;
-  return iter;
+  nh->nitems = nh->nslots;
+  if (nh->nslots > HASH_LINEAR_MAX)
+    build_index(nh);
+  return DohObjMalloc(&DohHashType, nh);
 }
 
 /* -----------------------------------------------------------------------------
@@ -404,12 +505,11 @@ int DohGetMaxHashExpand(void) {
  * ----------------------------------------------------------------------------- */
 
 static DOH *Hash_str(DOH *ho) {
-  int i, j;
-  HashNode *n;
+  int j;
+  Iterator i;
   DOH *s;
   static int expanded = 0;
   static const char *tab = "  ";
-  Hash *h = (Hash *) ObjData(ho);
 
   s = NewStringEmpty();
   if (ObjGetMark(ho)) {
@@ -419,28 +519,20 @@ static DOH *Hash_str(DOH *ho) {
   if (expanded >= max_expand) {
     /* replace each hash attribute with a '.' */
     Printf(s, "Hash(%p) {", ho);
-    for (i = 0; i < h->hashsize; i++) {
-      n = h->hashtable[i];
-      while (n) {
-	Putc('.', s);
-	n = n->next;
-      }
+    for (i = Hash_firstiter(ho); i.key; i = Hash_nextiter(i)) {
+      Putc('.', s);
     }
     Putc('}', s);
     return s;
   }
   ObjSetMark(ho, 1);
   Printf(s, "Hash(%p) {\n", ho);
-  for (i = 0; i < h->hashsize; i++) {
-    n = h->hashtable[i];
-    while (n) {
-      for (j = 0; j < expanded + 1; j++)
-	Printf(s, tab);
-      expanded += 1;
-      Printf(s, "'%s' : %s, \n", n->key, n->object);
-      expanded -= 1;
-      n = n->next;
-    }
+  for (i = Hash_firstiter(ho); i.key; i = Hash_nextiter(i)) {
+    for (j = 0; j < expanded + 1; j++)
+      Printf(s, tab);
+    expanded += 1;
+    Printf(s, "'%s' : %s, \n", i.key, i.item);
+    expanded -= 1;
   }
   for (j = 0; j < expanded; j++)
     Printf(s, tab);
@@ -460,44 +552,6 @@ static int Hash_len(DOH *ho) {
   return h->nitems;
 }
 
-/* -----------------------------------------------------------------------------
- * CopyHash()
- *
- * Make a copy of a hash table.  Note: this is a shallow copy.
- * ----------------------------------------------------------------------------- */
-
-static DOH *CopyHash(DOH *ho) {
-  Hash *h, *nh;
-  HashNode *n;
-  DOH *nho;
-
-  int i;
-  h = (Hash *) ObjData(ho);
-  nh = (Hash *) DohMalloc(sizeof(Hash));
-  nh->hashsize = h->hashsize;
-  nh->hashtable = (HashNode **) DohMalloc(nh->hashsize * sizeof(HashNode *));
-  for (i = 0; i < nh->hashsize; i++) {
-    nh->hashtable[i] = 0;
-  }
-  nh->nitems = 0;
-  nh->line = h->line;
-  nh->file = h->file;
-  if (nh->file)
-    Incref(nh->file);
-
-  nho = DohObjMalloc(&DohHashType, nh);
-  for (i = 0; i < h->hashsize; i++) {
-    n = h->hashtable[i];
-    while (n) {
-      Hash_setattr(nho, n->key, n->object);
-      n = n->next;
-    }
-  }
-  return nho;
-}
-
-
-
 static void Hash_setfile(DOH *ho, DOH *file) {
   DOH *fo;
   Hash *h = (Hash *) ObjData(ho);
@@ -572,14 +626,8 @@ DohObjInfo DohHashType = {
 
 DOH *DohNewHash(void) {
   Hash *h;
-  int i;
   h = (Hash *) DohMalloc(sizeof(Hash));
-  h->hashsize = HASH_INIT_SIZE;
-  h->hashtable = (HashNode **) DohMalloc(h->hashsize * sizeof(HashNode *));
-  for (i = 0; i < h->hashsize; i++) {
-    h->hashtable[i] = 0;
-  }
-  h->nitems = 0;
+  init_hash(h, 0);
   h->file = 0;
   h->line = 0;
   return DohObjMalloc(&DohHashType, h);
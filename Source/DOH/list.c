@@ -11,6 +11,7 @@
  *     Implements a simple list object.
  * ----------------------------------------------------------------------------- */
 
+#define DOH_MEMORY_TAG DOH_MEM_LIST
 #include "dohint.h"
 
 typedef struct List {
@@ -12,6 +12,7 @@
  *     of objects and checking of objects.
  * ----------------------------------------------------------------------------- */
 
+#define DOH_MEMORY_TAG DOH_MEM_POOL
 #include "dohint.h"
 
 #ifndef DOH_POOL_SIZE
@@ -40,6 +41,9 @@ typedef struct pool {
 static DohBase *FreeList = 0;	/* List of free objects */
 static Pool *Pools = 0;
 static int pools_initialized = 0;
+static unsigned long objects_allocated = 0;	/* Number of objects allocated */
+
+static void *mem_alloc(size_t size, int tag, int zero);
 
 /* ----------------------------------------------------------------------
  * CreatePool() - Create a new memory pool 
@@ -49,9 +53,10 @@ static void CreatePool() {
   Pool *p = 0;
   p = (Pool *) DohMalloc(sizeof(Pool));
   assert(p);
-  p->ptr = (DohBase *) DohMalloc(sizeof(DohBase) * PoolSize);
+  /* Zero filled memory for a large pool is mapped in lazily by the system,
+     so only the part of the pool that is actually used costs anything */
+  p->ptr = (DohBase *) mem_alloc(sizeof(DohBase) * PoolSize, DOH_MEMORY_TAG, 1);
   assert(p->ptr);
-  memset(p->ptr, 0, sizeof(DohBase) * PoolSize);
   p->len = PoolSize;
   p->blen = PoolSize * sizeof(DohBase);
   p->current = 0;
@@ -133,6 +138,7 @@ DOH *DohObjMalloc(DohObjInfo *type, void *data) {
 #ifndef DOH_DEBUG_MEMORY_POOLS
   }
 #endif
+  objects_allocated++;
   obj->type = type;
   obj->data = data;
   obj->meta = 0;
@@ -164,6 +170,262 @@ void DohObjFree(DOH *ptr) {
   }
 }
 
+/* -----------------------------------------------------------------------------
+ * Size-class allocator
+ *
+ * Object data (string buffers, hash slots, list items, ...) is allocated from
+ * here via the DohMalloc/DohRealloc/DohFree macros.  Small requests are rounded
+ * up to one of a fixed set of size classes and carved out of large chunks,
+ * freed blocks are kept on a free list per size class for re-use.  Requests
+ * larger than the largest size class go straight to malloc.  Every block is
+ * preceded by a small header recording its size class, its requested size and
+ * a tag identifying the kind of object that owns it, which is used to keep
+ * the statistics displayed by DohMemoryDebug().
+ * ----------------------------------------------------------------------------- */
+
+/* Use malloc for every block, for example when running under a memory checker.
+ * The statistics are still collected. */
+/*
+#define DOH_SYSTEM_MALLOC
+*/
+
+#ifndef DOH_CHUNK_SIZE
+#define DOH_CHUNK_SIZE        65536
+#endif
+
+typedef struct MemHeader {
+  unsigned int size;		/* Requested size */
+  unsigned char sclass;		/* Size class, MEM_LARGE if allocated with malloc */
+  unsigned char tag;		/* DOH_MEM_xxx owner tag */
+  unsigned short pad;
+} MemHeader;
+
+typedef struct MemBlock {
+  struct MemBlock *next;	/* Next free block of the same size class */
+} MemBlock;
+
+#define MEM_HEADER            ((size_t) sizeof(MemHeader))
+#define MEM_LARGE             255
+
+/* Block sizes, including the header.  All are multiples of 8. */
+static const unsigned int mem_class_size[] = {
+  16, 24, 32, 48, 64, 80, 96, 128, 160, 192, 256, 320, 384, 512, 768, 1024
+};
+
+#define MEM_NCLASSES          ((int) (sizeof(mem_class_size) / sizeof(mem_class_size[0])))
+#define MEM_MAX_SMALL         1024
+
+#ifdef DOH_SYSTEM_MALLOC
+#define MEM_IS_SMALL(total)   0
+#else
+#define MEM_IS_SMALL(total)   ((total) <= MEM_MAX_SMALL)
+#endif
+
+static unsigned char mem_class_lookup[MEM_MAX_SMALL / 8 + 1];	/* Block size / 8 -> size class */
+static MemBlock *mem_free[MEM_NCLASSES];
+static char *mem_chunk = 0;	/* Unused part of the current chunk */
+static size_t mem_chunk_avail = 0;
+static int mem_initialized = 0;
+
+/* Statistics */
+typedef struct MemStats {
+  size_t inuse;			/* Bytes requested and not yet freed */
+  size_t peak;			/* Maximum value of inuse */
+  size_t blocks;		/* Blocks in use */
+  size_t nalloc;		/* Number of allocations */
+} MemStats;
+
+static const char *mem_tag_names[DOH_MEM_NTAGS] = {
+  "Other", "Pools", "Strings", "Lists", "Hashes", "Keys", "Files", "Voids", "Printf"
+};
+
+static MemStats mem_tag_stats[DOH_MEM_NTAGS];
+static MemStats mem_total_stats;
+static size_t mem_class_carved[MEM_NCLASSES];	/* Blocks taken from chunks */
+static size_t mem_class_inuse[MEM_NCLASSES];	/* Blocks in use */
+static size_t mem_class_requested[MEM_NCLASSES];	/* Bytes requested by blocks in use */
+static size_t mem_chunk_bytes = 0;
+static size_t mem_large_bytes = 0;	/* Bytes in use by large blocks, including headers */
+static size_t mem_large_blocks = 0;
+
+static void mem_init(void) {
+  int c = 0;
+  unsigned int i;
+  for (i = 0; i <= MEM_MAX_SMALL / 8; i++) {
+    while (mem_class_size[c] < i * 8)
+      c++;
+    mem_class_lookup[i] = (unsigned char) c;
+  }
+  mem_initialized = 1;
+}
+
+static void mem_stats_alloc(MemStats *st, size_t size) {
+  st->inuse += size;
+  if (st->inuse > st->peak)
+    st->peak = st->inuse;
+  st->blocks++;
+  st->nalloc++;
+}
+
+static void mem_stats_free(MemStats *st, size_t size) {
+  st->inuse -= size;
+  st->blocks--;
+}
+
+static void mem_stats_resize(MemStats *st, size_t oldsize, size_t size) {
+  st->inuse = st->inuse - oldsize + size;
+  if (st->inuse > st->peak)
+    st->peak = st->inuse;
+}
+
+/* Carve a new block of the given size class out of the current chunk */
+static MemBlock *mem_carve(int c) {
+  size_t bsize = mem_class_size[c];
+  char *b;
+  if (mem_chunk_avail < bsize) {
+    /* Put what is left of the chunk on the free lists so that it is not wasted */
+    while (mem_chunk_avail >= mem_class_size[0]) {
+      int k = mem_class_lookup[mem_chunk_avail / 8];
+      MemBlock *fb;
+      if (mem_class_size[k] > mem_chunk_avail)
+	k--;
+      fb = (MemBlock *) mem_chunk;
+      fb->next = mem_free[k];
+      mem_free[k] = fb;
+      mem_class_carved[k]++;
+      mem_chunk += mem_class_size[k];
+      mem_chunk_avail -= mem_class_size[k];
+    }
+    mem_chunk = (char *) malloc(DOH_CHUNK_SIZE);
+    assert(mem_chunk);
+    mem_chunk_avail = DOH_CHUNK_SIZE;
+    mem_chunk_bytes += DOH_CHUNK_SIZE;
+  }
+  b = mem_chunk;
+  mem_chunk += bsize;
+  mem_chunk_avail -= bsize;
+  mem_class_carved[c]++;
+  return (MemBlock *) b;
+}
+
+/* Allocate a block, zero filled if zero is set */
+static void *mem_alloc(size_t size, int tag, int zero) {
+  MemHeader *h;
+  size_t total = size + MEM_HEADER;
+  if (!mem_initialized)
+    mem_init();
+  if (MEM_IS_SMALL(total)) {
+    int c = mem_class_lookup[(total + 7) / 8];
+    MemBlock *b = mem_free[c];
+    if (b)
+      mem_free[c] = b->next;
+    else
+      b = mem_carve(c);
+    h = (MemHeader *) b;
+    h->sclass = (unsigned char) c;
+    mem_class_inuse[c]++;
+    mem_class_requested[c] += size;
+    if (zero)
+      memset(h + 1, 0, size);
+  } else {
+    h = (MemHeader *) (zero ? calloc(1, total) : malloc(total));
+    if (!h)
+      return 0;
+    h->sclass = MEM_LARGE;
+    mem_large_bytes += total;
+    mem_large_blocks++;
+  }
+  h->size = (unsigned int) size;
+  h->tag = (unsigned char) tag;
+  h->pad = 0;
+  mem_stats_alloc(&mem_tag_stats[tag], size);
+  mem_stats_alloc(&mem_total_stats, size);
+  return (void *) (h + 1);
+}
+
+/* ----------------------------------------------------------------------
+ * DohMemMalloc()
+ *
+ * Allocate size bytes on behalf of an object of kind tag.
+ * ---------------------------------------------------------------------- */
+
+void *DohMemMalloc(size_t size, int tag) {
+  return mem_alloc(size, tag, 0);
+}
+
+/* ----------------------------------------------------------------------
+ * DohMemFree()
+ * ---------------------------------------------------------------------- */
+
+void DohMemFree(void *ptr) {
+  MemHeader *h;
+  int c;
+  if (!ptr)
+    return;
+  h = ((MemHeader *) ptr) - 1;
+  mem_stats_free(&mem_tag_stats[h->tag], h->size);
+  mem_stats_free(&mem_total_stats, h->size);
+  c = h->sclass;
+  if (c == MEM_LARGE) {
+    mem_large_bytes -= h->size + MEM_HEADER;
+    mem_large_blocks--;
+    free(h);
+  } else {
+    MemBlock *b = (MemBlock *) h;
+    mem_class_inuse[c]--;
+    mem_class_requested[c] -= h->size;
+    b->next = mem_free[c];
+    mem_free[c] = b;
+  }
+}
+
+/* ----------------------------------------------------------------------
+ * DohMemRealloc()
+ *
+ * Resize a block.  The block is resized in place if the new size still fits
+ * in its size class.
+ * ---------------------------------------------------------------------- */
+
+void *DohMemRealloc(void *ptr, size_t size, int tag) {
+  MemHeader *h;
+  size_t total = size + MEM_HEADER;
+  size_t oldsize;
+  void *nptr;
+  if (!ptr)
+    return DohMemMalloc(size, tag);
+  h = ((MemHeader *) ptr) - 1;
+  oldsize = h->size;
+  if (h->sclass == MEM_LARGE && !MEM_IS_SMALL(total)) {
+    h = (MemHeader *) realloc(h, total);
+    if (!h)
+      return 0;
+    mem_large_bytes = mem_large_bytes - oldsize + size;
+  } else if (h->sclass != MEM_LARGE && total <= mem_class_size[h->sclass]) {
+    mem_class_requested[h->sclass] = mem_class_requested[h->sclass] - oldsize + size;
+  } else {
+    nptr = DohMemMalloc(size, h->tag);
+    if (!nptr)
+      return 0;
+    memcpy(nptr, ptr, oldsize < size ? oldsize : size);
+    DohMemFree(ptr);
+    return nptr;
+  }
+  h->size = (unsigned int) size;
+  mem_stats_resize(&mem_tag_stats[h->tag], oldsize, size);
+  mem_stats_resize(&mem_total_stats, oldsize, size);
+  return (void *) (h + 1);
+}
+
+/* ----------------------------------------------------------------------
+ * DohMemoryAllocations()
+ *
+ * Number of objects and memory blocks allocated so far
+ * ---------------------------------------------------------------------- */
+
+unsigned long DohMemoryAllocations(void) {
+  return objects_allocated + (unsigned long) mem_total_stats.nalloc;
+}
+
 /* ----------------------------------------------------------------------
  * DohMemoryDebug()
  *
@@ -184,13 +446,17 @@ void DohMemoryDebug(void) {
   int numlist = 0;
   int numhash = 0;
 
+  int i;
+  size_t small_carved = 0;
+  size_t small_inuse = 0;
+  size_t small_requested = 0;
+
   printf("Memory statistics:\n\n");
   printf("Pools:\n");
 
   p = Pools;
   while (p) {
     /* Calculate number of used, free items */
-    int i;
     int nused = 0, nfree = 0;
     for (i = 0; i < p->len; i++) {
       if (p->ptr[i].refcount <= 0)
@@ -218,6 +484,29 @@ void DohMemoryDebug(void) {
   printf("    Lists     : %d\n", numlist);
   printf("    Hashes    : %d\n", numhash);
 
+  printf("\nAllocations by owner (bytes requested):\n");
+  printf("    %-10s %12s %12s %10s %10s\n", "", "in use", "peak", "blocks", "allocs");
+  for (i = 0; i < DOH_MEM_NTAGS; i++) {
+    MemStats *st = &mem_tag_stats[i];
+    printf("    %-10s %12lu %12lu %10lu %10lu\n", mem_tag_names[i], (unsigned long) st->inuse, (unsigned long) st->peak, (unsigned long) st->blocks, (unsigned long) st->nalloc);
+  }
+  printf("    %-10s %12lu %12lu %10lu %10lu\n", "Total", (unsigned long) mem_total_stats.inuse, (unsigned long) mem_total_stats.peak, (unsigned long) mem_total_stats.blocks, (unsigned long) mem_total_stats.nalloc);
+
+  printf("\nSize classes:\n");
+  printf("    %6s %10s %10s %10s %12s\n", "size", "carved", "in use", "free", "waste");
+  for (i = 0; i < MEM_NCLASSES; i++) {
+    size_t waste = mem_class_inuse[i] * (mem_class_size[i] - MEM_HEADER) - mem_class_requested[i];
+    if (!mem_class_carved[i])
+      continue;
+    printf("    %6u %10lu %10lu %10lu %12lu\n", mem_class_size[i], (unsigned long) mem_class_carved[i], (unsigned long) mem_class_inuse[i], (unsigned long) (mem_class_carved[i] - mem_class_inuse[i]), (unsigned long) waste);
+    small_carved += mem_class_carved[i] * mem_class_size[i];
+    small_inuse += mem_class_inuse[i] * mem_class_size[i];
+    small_requested += mem_class_requested[i];
+  }
+  printf("\n    Chunks        : %lu bytes, %lu carved into blocks\n", (unsigned long) mem_chunk_bytes, (unsigned long) small_carved);
+  printf("    Small blocks  : %lu bytes in use, %lu bytes requested, %lu bytes free\n", (unsigned long) small_inuse, (unsigned long) small_requested, (unsigned long) (small_carved - small_inuse));
+  printf("    Large blocks  : %lu bytes in %lu blocks\n", (unsigned long) mem_large_bytes, (unsigned long) mem_large_blocks);
+
 #if 0
   p = Pools;
   while (p) {
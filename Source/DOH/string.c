@@ -12,6 +12,7 @@
  *     file semantics.
  * ----------------------------------------------------------------------------- */
 
+#define DOH_MEMORY_TAG DOH_MEM_STRING
 #include "dohint.h"
 
 extern DohObjInfo DohStringType;
@@ -26,6 +27,48 @@ typedef struct String {
   char *str;			/* String data        */
 } String;
 
+/* Strings needing no more than this many bytes when created keep their data in
+   the same block of memory as the String structure, saving an allocation */
+#define STRING_INLINE_MAXSIZE  64
+
+#define STRING_IS_INLINE(s)    ((s)->str == (char *) ((s) + 1))
+
+/* -----------------------------------------------------------------------------
+ * String_alloc() - Allocate a String with a buffer of max bytes
+ * ----------------------------------------------------------------------------- */
+
+static String *String_alloc(int max) {
+  String *str;
+  if (max <= STRING_INLINE_MAXSIZE) {
+    str = (String *) DohMalloc(sizeof(String) + max);
+    str->str = (char *) (str + 1);
+  } else {
+    str = (String *) DohMalloc(sizeof(String));
+    str->str = (char *) DohMalloc(max);
+  }
+  str->maxsize = max;
+  return str;
+}
+
+/* -----------------------------------------------------------------------------
+ * String_resize() - Change the size of the buffer holding the string data
+ *
+ * An inline buffer cannot be resized, the data is moved to a separate buffer.
+ * ----------------------------------------------------------------------------- */
+
+static void String_resize(String *s, int newmaxsize) {
+  if (STRING_IS_INLINE(s)) {
+    char *c = (char *) DohMalloc(newmaxsize);
+    int n = s->len + 1;
+    memcpy(c, s->str, n < newmaxsize ? n : newmaxsize);
+    s->str = c;
+  } else {
+    s->str = (char *) DohRealloc(s->str, newmaxsize);
+  }
+  assert(s->str);
+  s->maxsize = newmaxsize;
+}
+
 /* -----------------------------------------------------------------------------
  * String_data() - Return as a 'void *'
  * ----------------------------------------------------------------------------- */
@@ -66,14 +109,13 @@ static int String_dump(DOH *so, DOH *out) {
 static DOH *CopyString(DOH *so) {
   String *str;
   String *s = (String *) ObjData(so);
-  str = (String *) DohMalloc(sizeof(String));
+  str = String_alloc(s->len + 1);
   str->hashkey = s->hashkey;
   str->sp = s->sp;
   str->line = s->line;
   str->file = s->file;
   if (str->file)
     Incref(str->file);
-  str->str = (char *) DohMalloc(s->len + 1);
   memcpy(str->str, s->str, s->len);
   str->maxsize = s->len;
   str->len = s->len;
@@ -88,7 +130,8 @@ static DOH *CopyString(DOH *so) {
 
 static void DelString(DOH *so) {
   String *s = (String *) ObjData(so);
-  DohFree(s->str);
+  if (!STRING_IS_INLINE(s))
+    DohFree(s->str);
   DohFree(s);
 }
 
@@ -228,9 +271,7 @@ static void DohString_append(DOH *so, const DOHString_or_char *str) {
     newmaxsize = 2 * s->maxsize;
     if (newlen >= newmaxsize - 1)
       newmaxsize = newlen + 1;
-    s->str = (char *) DohRealloc(s->str, newmaxsize);
-    assert(s->str);
-    s->maxsize = newmaxsize;
+    String_resize(s, newmaxsize);
   }
   tc = s->str;
   memcpy(tc + oldlen, newstr, l + 1);
@@ -294,10 +335,7 @@ static int String_insert(DOH *so, int pos, DOH *str) {
 
   /* See if there is room to insert the new data */
   while (s->maxsize <= s->len + len) {
-    int newsize = 2 * s->maxsize;
-    s->str = (char *) DohRealloc(s->str, newsize);
-    assert(s->str);
-    s->maxsize = newsize;
+    String_resize(s, 2 * s->maxsize);
   }
   memmove(s->str + pos + len, s->str + pos, (s->len - pos));
   memcpy(s->str + pos, data, len);
@@ -423,9 +461,8 @@ static int String_write(DOH *so, const void *buffer, int len) {
     s->sp = s->len;
   newlen = s->sp + len + 1;
   if (newlen > s->maxsize) {
-    s->str = (char *) DohRealloc(s->str, newlen);
-    assert(s->str);
-    s->maxsize = newlen;
+    /* Grow geometrically so that strings built up by repeated writes are not quadratic */
+    String_resize(s, newlen < 2 * s->maxsize ? 2 * s->maxsize : newlen);
     s->len = s->sp + len;
   }
   if ((s->sp + len) > s->len)
@@ -512,16 +549,10 @@ static int String_putc(DOH *so, int ch) {
   int sp = s->sp;
   s->hashkey = -1;
   if (sp >= len) {
-    int maxsize = s->maxsize;
-    char *tc = s->str;
-    if (len > (maxsize - 2)) {
-      maxsize *= 2;
-      tc = (char *) DohRealloc(tc, maxsize);
-      assert(tc);
-      s->maxsize = (int) maxsize;
-      s->str = tc;
-    }
-    tc += sp;
+    char *tc;
+    if (len > (s->maxsize - 2))
+      String_resize(s, s->maxsize * 2);
+    tc = s->str + sp;
     *tc = (char) ch;
     *(++tc) = 0;
     s->len = s->sp = sp + 1;
@@ -998,7 +1029,8 @@ static int replace_simple(String *str, char *token, char *rep, int flags, int co
     str->len += expand;
     str->str[str->len] = 0;
     str->maxsize = newsize;
-    DohFree(c);
+    if (c != (char *) (str + 1))
+      DohFree(c);
     return rcount;
   }
 }
@@ -1150,18 +1182,16 @@ DOHString *DohNewString(const DOHString_or_char *so) {
     l = s ? (int) strlen(s) : 0;
   }
 
-  str = (String *) DohMalloc(sizeof(String));
-  str->hashkey = hashkey;
-  str->sp = 0;
-  str->line = 1;
-  str->file = 0;
   max = INIT_MAXSIZE;
   if (s) {
     if ((l + 1) > max)
       max = l + 1;
   }
-  str->str = (char *) DohMalloc(max);
-  str->maxsize = max;
+  str = String_alloc(max);
+  str->hashkey = hashkey;
+  str->sp = 0;
+  str->line = 1;
+  str->file = 0;
   if (s) {
     strcpy(str->str, s);
     str->len = l;
@@ -1179,14 +1209,11 @@ DOHString *DohNewString(const DOHString_or_char *so) {
  * ----------------------------------------------------------------------------- */
 
 DOHString *DohNewStringEmpty(void) {
-  int max = INIT_MAXSIZE;
-  String *str = (String *) DohMalloc(sizeof(String));
+  String *str = String_alloc(INIT_MAXSIZE);
   str->hashkey = 0;
   str->sp = 0;
   str->line = 1;
   str->file = 0;
-  str->str = (char *) DohMalloc(max);
-  str->maxsize = max;
   str->str[0] = 0;
   str->len = 0;
   return DohObjMalloc(&DohStringType, str);
@@ -1206,19 +1233,17 @@ DOHString *DohNewStringWithSize(const DOHString_or_char *so, int len) {
     s = (char *) so;
   }
 
-  str = (String *) DohMalloc(sizeof(String));
-  str->hashkey = -1;
-  str->sp = 0;
-  str->line = 1;
-  str->file = 0;
   max = INIT_MAXSIZE;
   if (s) {
     l = (int) len;
     if ((l + 1) > max)
       max = l + 1;
   }
-  str->str = (char *) DohMalloc(max);
-  str->maxsize = max;
+  str = String_alloc(max);
+  str->hashkey = -1;
+  str->sp = 0;
+  str->line = 1;
+  str->file = 0;
   if (s) {
     strncpy(str->str, s, len);
     str->str[l] = 0;
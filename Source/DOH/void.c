@@ -12,6 +12,7 @@
  *     an arbitrary C object represented as a void *.
  * ----------------------------------------------------------------------------- */
 
+#define DOH_MEMORY_TAG DOH_MEM_VOID
 #include "dohint.h"
 
 typedef struct {
@@ -89,6 +89,8 @@ extern int AddExtern;
  * ---------------------------------------------------------------------- */
 
 int Dispatcher::emit_one(Node *n) {
+  static String *key_error = InternKey("error");
+  static String *key_warnfilter = InternKey("feature:warnfilter");
   int ret = SWIG_OK;
 
   char *tag = Char(nodeType(n));
@@ -100,11 +102,11 @@ int Dispatcher::emit_one(Node *n) {
 
   /* Do not proceed if marked with an error */
 
-  if (Getattr(n, "error"))
+  if (Getattr(n, key_error))
     return SWIG_OK;
 
   /* Look for warnings */
-  String *wrn = Getattr(n, "feature:warnfilter");
+  String *wrn = Getattr(n, key_warnfilter);
   if (wrn)
     Swig_warnfilter(wrn, 1);
 
@@ -123,7 +125,14 @@ int Dispatcher::emit_one(Node *n) {
   } else if (strcmp(tag, "enumforward") == 0) {
     ret = enumforwardDeclaration(n);
   } else if (strcmp(tag, "class") == 0) {
+    if (Swig_profile_enabled()) {
+      String *name = Getattr(n, "name");
+      name = name ? SwigType_namestr(name) : NewString("");
+      Swig_profile_begin("class", name);
+      Delete(name);
+    }
     ret = classDeclaration(n);
+    Swig_profile_end();
   } else if (strcmp(tag, "classforward") == 0) {
     ret = classforwardDeclaration(n);
   } else if (strcmp(tag, "constructor") == 0) {
@@ -370,17 +379,20 @@ Language::~Language() {
    ---------------------------------------------------------------------- */
 
 int Language::emit_one(Node *n) {
+  static String *key_ignore = InternKey("feature:ignore");
+  static String *key_onlychildren = InternKey("feature:onlychildren");
+  static String *key_extend = InternKey("feature:extend");
   int ret;
   int oldext;
   if (!n)
     return SWIG_OK;
 
-  if (GetFlag(n, "feature:ignore")
-      && !Getattr(n, "feature:onlychildren"))
+  if (GetFlag(n, key_ignore)
+      && !Getattr(n, key_onlychildren))
     return SWIG_OK;
 
   oldext = Extend;
-  if (Getattr(n, "feature:extend"))
+  if (Getattr(n, key_extend))
     Extend = 1;
 
   line_number = Getline(n);
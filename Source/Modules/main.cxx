@@ -62,8 +62,10 @@ static const char *usage1 = (const char *) "\
 \nGeneral Options\n\
      -addextern      - Add extra extern declarations\n\
      -c++            - Enable C++ processing\n\
+     -changedfiles <file> - Write the names of the output files that were written to <file>\n\
      -co <file>      - Check <file> out of the SWIG library\n\
      -copyctor       - Automatically generate copy constructors wherever possible\n\
+     -cppcache <dir> - Save the preprocessed included files in <dir> and reuse them\n\
      -cpperraswarn   - Treat the preprocessor #error statement as #warning (default)\n\
      -cppext <ext>   - Change file extension of generated C++ files to <ext>\n\
                        (default is cxx)\n\
@@ -83,6 +85,8 @@ static const char *usage1 = (const char *) "\
      -debug-tmused   - Display typemaps used debugging information\n\
      -directors      - Turn on director mode for all the classes, mainly for testing\n\
      -dirprot        - Turn on wrapping of protected members for director classes (default)\n\
+     -dispatchcache  - Make overload dispatchers try the overload chosen by the previous call first\n\
+                       when the arguments have the same types (pointer typechecks only)\n\
      -D<symbol>      - Define a symbol <symbol> (for conditional compilation)\n\
 ";
 
@@ -95,6 +99,7 @@ static const char *usage2 = (const char *) "\
                        features, eg -features directors,autodoc=1\n\
                        If no explicit value is given to the feature, a default of 1 is used\n\
      -fastdispatch   - Enable fast dispatch mode to produce faster overload dispatcher code\n\
+     -fastcpp        - Use the faster buffer based macro expansion in the preprocessor\n\
      -Fmicrosoft     - Display error/warning messages in Microsoft format\n\
      -Fstandard      - Display error/warning messages in commonly used format\n\
      -fvirtual       - Compile in virtual elimination mode\n\
@@ -104,6 +109,7 @@ static const char *usage2 = (const char *) "\
      -ignoremissing  - Ignore missing include files\n\
      -importall      - Follow all #include statements as imports\n\
      -includeall     - Follow all #include statements\n\
+     -keepunchanged  - Leave output files whose contents are unchanged as they are\n\
      -l<ifile>       - Include SWIG library file <ifile>\n\
 ";
 
@@ -118,6 +124,7 @@ static const char *usage3 = (const char *) "\
      -module <name>  - Set module name to <name>\n\
      -MP             - Generate phony targets for all dependencies\n\
      -MT <target>    - Set the target of the rule emitted by dependency generation\n\
+     -multilang      - Generate the wrappers for each of the target language options given\n\
      -nocontract     - Turn off contract checking\n\
      -nocpperraswarn - Do not treat the preprocessor #error statement as #warning\n\
      -nodefault      - Do not generate default constructors nor default destructors\n\
@@ -138,8 +145,12 @@ static const char *usage4 = (const char *) "\
      -outcurrentdir  - Set default output dir to current dir instead of input file's path\n\
      -outdir <dir>   - Set language specific files output directory to <dir>\n\
      -pcreversion    - Display PCRE version information\n\
+     -profile        - Display the wall time and allocations per phase, included file and class\n\
+     -profile-trace <file> - Profile as -profile and write every interval to <file> as Chrome trace events\n\
      -small          - Compile in virtual elimination and compact mode\n\
      -swiglib        - Report location of SWIG library and exit\n\
+     -switchdispatch - Generate overload dispatchers that switch on the argument count and\n\
+                       evaluate each distinct typecheck at most once\n\
      -templatereduce - Reduce all the typedefs in templates\n\
      -v              - Run in verbose mode\n\
      -version        - Display SWIG version number\n\
@@ -176,6 +187,7 @@ static const char *hpp_extension = "h";
 static const char *cpp_extension = "cxx";
 static const char *depends_extension = "d";
 static String *outdir = 0;
+static String *output_subdirectory = 0;
 static String *xmlout = 0;
 static int outcurrentdir = 0;
 static int help = 0;
@@ -185,6 +197,7 @@ static int no_cpp = 0;
 static String *outfile_name = 0;
 static String *outfile_name_h = 0;
 static int tm_debug = 0;
+static int tm_search_debug = 0;
 static int dump_symtabs = 0;
 static int dump_symbols = 0;
 static int dump_csymbols = 0;
@@ -201,10 +214,13 @@ static int depend = 0;
 static int depend_only = 0;
 static int depend_phony = 0;
 static int memory_debug = 0;
+static int keep_unchanged = 0;
 static int allkw = 0;
 static DOH *cpps = 0;
 static String *dependencies_file = 0;
 static String *dependencies_target = 0;
+static String *changed_files_file = 0;
+static String *profile_trace_file = 0;
 static int external_runtime = 0;
 static String *external_runtime_name = 0;
 enum { STAGE1=1, STAGE2=2, STAGE3=4, STAGE4=8, STAGEOVERFLOW=16 };
@@ -319,6 +335,33 @@ static void configure_outdir(const String *c_wrapper_outfile) {
   }
 }
 
+/* -----------------------------------------------------------------------------
+ * in_output_subdirectory()
+ *
+ * Returns where an output file goes when generating several target languages
+ * at once: in the language's subdirectory of its directory, which is created
+ * if need be.
+ * ----------------------------------------------------------------------------- */
+
+static String *in_output_subdirectory(const String *filename) {
+  String *dirname = Swig_file_dirname(filename);
+  String *basename = Swig_file_filename(filename);
+  String *error = Swig_new_subdirectory(dirname, output_subdirectory);
+  if (error) {
+    Printf(stderr, "%s\n", error);
+    SWIG_exit(EXIT_FAILURE);
+  }
+  String *result = NewStringf("%s%s%s%s", dirname, output_subdirectory, SWIG_FILE_DELIMITER, basename);
+  Delete(basename);
+  Delete(dirname);
+  return result;
+}
+
+/* Sets the subdirectory for all the output files, see in_output_subdirectory() */
+void SWIG_output_subdirectory(const char *subdirectory) {
+  output_subdirectory = NewString(subdirectory);
+}
+
 /* This function sets the name of the configuration file */
 void SWIG_config_file(const_String_or_char_ptr filename) {
   lang_config = NewString(filename);
@@ -512,6 +555,12 @@ static void getoptions(int argc, char *argv[]) {
       } else if (strcmp(argv[i], "-nofastdispatch") == 0) {
 	Wrapper_fast_dispatch_mode_set(0);
 	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-switchdispatch") == 0) {
+	Wrapper_switch_dispatch_mode_set(1);
+	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-dispatchcache") == 0) {
+	Wrapper_dispatch_cache_mode_set(1);
+	Swig_mark_arg(i);
       } else if (strcmp(argv[i], "-naturalvar") == 0) {
 	Wrapper_naturalvar_mode_set(1);
 	Swig_mark_arg(i);
@@ -671,6 +720,33 @@ static void getoptions(int argc, char *argv[]) {
 	} else {
 	  Swig_arg_error();
 	}
+      } else if (strcmp(argv[i], "-keepunchanged") == 0) {
+	keep_unchanged = 1;
+	KeepUnchangedFiles(1);
+	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-changedfiles") == 0) {
+	Swig_mark_arg(i);
+	if (argv[i + 1]) {
+	  changed_files_file = NewString(argv[i + 1]);
+	  Swig_mark_arg(i + 1);
+	} else {
+	  Swig_arg_error();
+	}
+      } else if (strcmp(argv[i], "-profile") == 0) {
+	Swig_profile_enable();
+	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-profile-trace") == 0) {
+	Swig_mark_arg(i);
+	if (argv[i + 1]) {
+	  Swig_profile_enable();
+	  profile_trace_file = NewString(argv[i + 1]);
+	  Swig_mark_arg(i + 1);
+	} else {
+	  Swig_arg_error();
+	}
+      } else if (strcmp(argv[i], "-fastcpp") == 0) {
+	Preprocessor_fast_expansion(1);
+	Swig_mark_arg(i);
       } else if (strcmp(argv[i], "-freeze") == 0) {
 	freeze = 1;
 	Swig_mark_arg(i);
@@ -683,6 +759,14 @@ static void getoptions(int argc, char *argv[]) {
       } else if (strcmp(argv[i], "-ignoremissing") == 0) {
 	Preprocessor_ignore_missing(1);
 	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-cppcache") == 0) {
+	Swig_mark_arg(i);
+	if (argv[i + 1]) {
+	  Preprocessor_cache_dir(argv[i + 1]);
+	  Swig_mark_arg(i + 1);
+	} else {
+	  Swig_arg_error();
+	}
       } else if (strcmp(argv[i], "-cpperraswarn") == 0) {
 	Preprocessor_error_as_warning(1);
 	Swig_mark_arg(i);
@@ -703,6 +787,7 @@ static void getoptions(int argc, char *argv[]) {
 	Swig_mark_arg(i);
       } else if (strcmp(argv[i], "-debug-tmsearch") == 0) {
 	Swig_typemap_search_debug_set();
+	tm_search_debug = 1;
 	Swig_mark_arg(i);
       } else if (strcmp(argv[i], "-debug-tmused") == 0) {
 	Swig_typemap_used_debug_set();
@@ -1096,7 +1181,9 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
 	  Printf(fs, "\n%%include \"%s\"\n", Swig_filename_escape(Getitem(libfiles, i)));
 	}
 	Seek(fs, 0, SEEK_SET);
+	Swig_profile_begin("phase", "preprocess");
 	cpps = Preprocessor_parse(fs);
+	Swig_profile_end();
 	Delete(fs);
       } else {
 	cpps = Swig_read_file(df);
@@ -1125,6 +1212,16 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
 	  } else {
 	    outfile = NewString(outfile_name);
 	  }
+	  if (output_subdirectory) {
+	    String *subdir_outfile = in_output_subdirectory(outfile);
+	    Delete(outfile);
+	    outfile = subdir_outfile;
+	    if (dependencies_file && Len(dependencies_file) != 0) {
+	      String *subdir_dependencies_file = in_output_subdirectory(dependencies_file);
+	      Delete(dependencies_file);
+	      dependencies_file = subdir_dependencies_file;
+	    }
+	  }
 	  if (dependencies_file && Len(dependencies_file) != 0) {
 	    f_dependencies_file = NewFile(dependencies_file, "w", SWIG_output_files());
 	    if (!f_dependencies_file) {
@@ -1133,6 +1230,11 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
 	    }
 	  } else if (!depend_only) {
 	    String *filename = NewStringf("%s_wrap.%s", basename, depends_extension);
+	    if (output_subdirectory) {
+	      String *subdir_filename = in_output_subdirectory(filename);
+	      Delete(filename);
+	      filename = subdir_filename;
+	    }
 	    f_dependencies_file = NewFile(filename, "w", SWIG_output_files());
 	    if (!f_dependencies_file) {
 	      FileErrorDisplay(filename);
@@ -1191,7 +1293,9 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
       fflush(stdout);
     }
 
+    Swig_profile_begin("phase", "parse");
     Node *top = Swig_cparse(cpps);
+    Swig_profile_end();
 
     if (dump_top & STAGE1) {
       Printf(stdout, "debug-top stage 1\n");
@@ -1211,7 +1315,9 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
     if (Verbose) {
       Printf(stdout, "Processing types...\n");
     }
+    Swig_profile_begin("phase", "typepass");
     Swig_process_types(top);
+    Swig_profile_end();
 
     if (dump_top & STAGE2) {
       Printf(stdout, "debug-top stage 2\n");
@@ -1225,12 +1331,16 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
     if (Verbose) {
       Printf(stdout, "C++ analysis...\n");
     }
+    Swig_profile_begin("phase", "allocate");
     Swig_default_allocators(top);
+    Swig_profile_end();
 
     if (CPlusPlus) {
       if (Verbose)
 	Printf(stdout, "Processing nested classes...\n");
+      Swig_profile_begin("phase", "nested");
       Swig_nested_process_classes(top);
+      Swig_profile_end();
     }
 
     if (dump_top & STAGE3) {
@@ -1308,6 +1418,22 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
 	} else {
 	  Setattr(top, "outfile_h", outfile_name_h);
 	}
+	if (output_subdirectory) {
+	  String *subdir_outfile = in_output_subdirectory(Getattr(top, "outfile"));
+	  String *subdir_outfile_h = in_output_subdirectory(Getattr(top, "outfile_h"));
+	  Setattr(top, "outfile", subdir_outfile);
+	  Setattr(top, "outfile_h", subdir_outfile_h);
+	  Delete(subdir_outfile_h);
+	  Delete(subdir_outfile);
+	  if (outdir && Len(outdir) != 0) {
+	    String *outdir_file = NewStringf("%s%s", outdir, SWIG_FILE_DELIMITER);
+	    String *subdir_outdir_file = in_output_subdirectory(outdir_file);
+	    Delete(outdir);
+	    outdir = Swig_file_dirname(subdir_outdir_file);
+	    Delete(subdir_outdir_file);
+	    Delete(outdir_file);
+	  }
+	}
 	configure_outdir(Getattr(top, "outfile"));
 	if (Swig_contract_mode_get()) {
 	  Swig_contracts(top);
@@ -1323,7 +1449,9 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
 	    tlm->help ? tlm->help : "", tlm->name);
 	}
 
+	Swig_profile_begin("phase", "generate");
 	lang->top(top);
+	Swig_profile_end();
 
 	if (browse) {
 	  Swig_browser(top, 0);
@@ -1352,6 +1480,10 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
   }
   if (tm_debug)
     Swig_typemap_debug();
+  if (tm_search_debug)
+    Swig_typemap_search_debug_stats();
+  if (dump_typedef)
+    SwigType_typedef_cache_debug_stats();
   if (memory_debug)
     DohMemoryDebug();
 
@@ -1379,6 +1511,45 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
 
   delete lang;
 
+  /* Output files still open are only in place, with -keepunchanged, and listed as changed once closed */
+  if (keep_unchanged || changed_files_file) {
+    CloseAllOpenFiles();
+    if (UnreplacedFiles())
+      SWIG_exit(EXIT_FAILURE);
+  }
+
+  if (changed_files_file) {
+    if (output_subdirectory) {
+      String *subdir_changed_files_file = in_output_subdirectory(changed_files_file);
+      Delete(changed_files_file);
+      changed_files_file = subdir_changed_files_file;
+    }
+    File *f_changed_files = NewFile(changed_files_file, "w", 0);
+    if (!f_changed_files) {
+      FileErrorDisplay(changed_files_file);
+      SWIG_exit(EXIT_FAILURE);
+    }
+    List *changed = ChangedFiles();
+    for (int i = 0; i < Len(changed); i++)
+      Printf(f_changed_files, "%s\n", Getitem(changed, i));
+    Delete(f_changed_files);
+  }
+
+  if (Swig_profile_enabled()) {
+    Swig_profile_report();
+    if (profile_trace_file) {
+      if (output_subdirectory) {
+	String *subdir_profile_trace_file = in_output_subdirectory(profile_trace_file);
+	Delete(profile_trace_file);
+	profile_trace_file = subdir_profile_trace_file;
+      }
+      if (!Swig_profile_trace(profile_trace_file)) {
+	FileErrorDisplay(profile_trace_file);
+	SWIG_exit(EXIT_FAILURE);
+      }
+    }
+  }
+
   int error_count = werror ? Swig_warn_count() : 0;
   error_count += Swig_error_count();
 
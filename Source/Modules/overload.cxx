@@ -21,6 +21,9 @@
 String *argv_template_string;
 String *argc_template_string;
 
+/* Identity of the type of an argument, for the dispatch cache */
+String *typeid_template_string;
+
 struct Overloaded {
   Node *n;			/* Node                               */
   int argc;			/* Argument count                     */
@@ -31,6 +34,8 @@ struct Overloaded {
 
 static int fast_dispatch_mode = 0;
 static int cast_dispatch_mode = 0;
+static int switch_dispatch_mode = 0;
+static int dispatch_cache_mode = 0;
 
 /* Set fast_dispatch_mode */
 void Wrapper_fast_dispatch_mode_set(int flag) {
@@ -41,6 +46,14 @@ void Wrapper_cast_dispatch_mode_set(int flag) {
   cast_dispatch_mode = flag;
 }
 
+void Wrapper_switch_dispatch_mode_set(int flag) {
+  switch_dispatch_mode = flag;
+}
+
+void Wrapper_dispatch_cache_mode_set(int flag) {
+  dispatch_cache_mode = flag;
+}
+
 /* -----------------------------------------------------------------------------
  * mark_implicitconv_function()
  *
@@ -771,9 +784,237 @@ static String *overload_dispatch_fast(Node *n, const_String_or_char_ptr fmt, int
   return f;
 }
 
+/*
+  Switch dispatch mechanism.  The candidates are grouped by the argument counts
+  they accept into the cases of a switch on argc, so the argument count is
+  tested once.  Within a case, a typecheck which several candidates make on the
+  same argument is computed at most once and its result kept in a local tag
+  variable.  Candidates are still tried in rank order, so the function chosen
+  is the same as with the default mechanism.
+*/
+static String *overload_dispatch_switch(Node *n, const_String_or_char_ptr fmt, int *maxargs, const_String_or_char_ptr fmt_fastdispatch) {
+  int i, j, k;
+
+  *maxargs = 1;
+
+  String *f = NewString("");
+
+  /* Get a list of methods ranked by precedence values and argument count */
+  List *dispatch = Swig_overload_rank(n, true);
+  int nfunc = Len(dispatch);
+  int offset = GetFlag(n, "wrap:this") ? 1 : 0;
+  bool fast = fast_dispatch_mode || GetFlag(n, "feature:fastdispatch");
+
+  /* Expand the typechecks of each candidate once, "" for an argument without one */
+  List *checks = NewList();
+  int *num_required = new int[nfunc];
+  int *num_arguments = new int[nfunc];
+  int *candidates = new int[nfunc];
+  for (i = 0; i < nfunc; i++) {
+    Node *ni = Getitem(dispatch, i);
+    Parm *pi = Getattr(ni, "wrap:parms");
+    bool implicitconvtypecheckoff = GetFlag(ni, "implicitconvtypecheckoff") != 0;
+    num_required[i] = emit_num_required(pi) + offset;
+    num_arguments[i] = emit_num_arguments(pi) + offset;
+    if (num_arguments[i] > *maxargs)
+      *maxargs = num_arguments[i];
+
+    List *argchecks = NewList();
+    j = 0;
+    Parm *pj = pi;
+    while (pj) {
+      if (checkAttribute(pj, "tmap:in:numinputs", "0")) {
+	pj = Getattr(pj, "tmap:in:next");
+	continue;
+      }
+      String *tm = NewString("");
+      print_typecheck(tm, j + offset, pj, implicitconvtypecheckoff);
+      Append(argchecks, tm);
+      Delete(tm);
+      if (!Getattr(pj, "tmap:in:SWIGTYPE") && Getattr(pj, "tmap:typecheck:SWIGTYPE")) {
+	/* we emit  a warning if the argument defines the 'in' typemap, but not the 'typecheck' one */
+	Swig_warning(WARN_TYPEMAP_TYPECHECK_UNDEF, Getfile(ni), Getline(ni),
+		     "Overloaded method %s with no explicit typecheck typemap for arg %d of type '%s'\n",
+		     Swig_name_decl(n), j, SwigType_str(Getattr(pj, "type"), 0));
+      }
+      Parm *pk = Getattr(pj, "tmap:in:next");
+      if (pk)
+	pj = pk;
+      else
+	pj = nextSibling(pj);
+      j++;
+    }
+    Append(checks, argchecks);
+    Delete(argchecks);
+    if (implicitconvtypecheckoff)
+      Delattr(ni, "implicitconvtypecheckoff");
+  }
+
+  Printf(f, "switch (%s) {\n", argc_template_string);
+  for (int argc = 0; argc <= *maxargs; argc++) {
+    int ncandidates = 0;
+    for (i = 0; i < nfunc; i++) {
+      if (num_required[i] <= argc && argc <= num_arguments[i])
+	candidates[ncandidates++] = i;
+    }
+    if (ncandidates == 0)
+      continue;
+
+    /* With fast dispatch the last candidate for this argument count needs no typechecks */
+    int nchecked = fast ? ncandidates - 1 : ncandidates;
+
+    /* Count how many candidates make each typecheck */
+    Hash *uses = NewHash();
+    for (k = 0; k < nchecked; k++) {
+      List *argchecks = Getitem(checks, candidates[k]);
+      for (j = 0; j + offset < argc; j++) {
+	String *tm = Getitem(argchecks, j);
+	if (Len(tm) > 0) {
+	  String *count = Getattr(uses, tm);
+	  count = NewStringf("%d", count ? atoi(Char(count)) + 1 : 1);
+	  Setattr(uses, tm, count);
+	  Delete(count);
+	}
+      }
+    }
+
+    String *decls = NewString("");
+    String *body = NewString("");
+    Hash *tags = NewHash();
+    bool need_v = false;
+    for (k = 0; k < ncandidates; k++) {
+      i = candidates[k];
+      Node *ni = Getitem(dispatch, i);
+      int num_braces = 0;
+      Printf(body, "{\n");
+      if (k < nchecked) {
+	List *argchecks = Getitem(checks, i);
+	for (j = 0; j + offset < argc; j++) {
+	  String *tm = Getitem(argchecks, j);
+	  if (Len(tm) == 0)
+	    continue;
+	  if (atoi(Char(Getattr(uses, tm))) > 1) {
+	    String *tag = Getattr(tags, tm);
+	    if (!tag) {
+	      tag = NewStringf("_t%d", Len(tags));
+	      Setattr(tags, tm, tag);
+	      Printf(decls, "int %s = -1;\n", tag);
+	      Delete(tag);
+	    }
+	    Printf(body, "if (%s < 0) {\n", tag);
+	    Printv(body, tm, NIL);
+	    Printf(body, "%s = _v != 0;\n", tag);
+	    Printf(body, "}\n");
+	    Printf(body, "if (%s) {\n", tag);
+	  } else {
+	    Printv(body, tm, NIL);
+	    Printf(body, "if (_v) {\n");
+	  }
+	  need_v = true;
+	  num_braces++;
+	}
+      }
+      // The language module may want to generate different code for last overloaded function called (with same number of arguments)
+      String *lfmt = ReplaceFormat(k == nchecked && fmt_fastdispatch ? fmt_fastdispatch : fmt, num_arguments[i]);
+      Printf(body, Char(lfmt), Getattr(ni, "wrap:name"));
+      Delete(lfmt);
+      /* close braces */
+      for ( /* empty */ ; num_braces > 0; num_braces--)
+	Printf(body, "}\n");
+      Printf(body, "}\n");
+    }
+
+    Printf(f, "case %d: {\n", argc);
+    if (need_v)
+      Printf(f, "int _v = 0;\n");
+    Printv(f, decls, body, NIL);
+    Printf(f, "break;\n");
+    Printf(f, "}\n");
+    Delete(tags);
+    Delete(body);
+    Delete(decls);
+    Delete(uses);
+  }
+  Printf(f, "default:\n");
+  Printf(f, "break;\n");
+  Printf(f, "}\n");
+
+  delete [] candidates;
+  delete [] num_arguments;
+  delete [] num_required;
+  Delete(checks);
+  Delete(dispatch);
+  return f;
+}
+
+/* -----------------------------------------------------------------------------
+ * dispatch_cache_possible()
+ *
+ * The dispatch cache assumes that the overload chosen only depends on the
+ * number of arguments and on the type of each argument.  This holds for the
+ * pointer typechecks, but not for conversions which also look at the value,
+ * such as the numeric typechecks or implicit conversions.
+ * ----------------------------------------------------------------------------- */
+
+static bool dispatch_cache_possible(Node *n) {
+  if (!typeid_template_string)
+    return false;
+  for (Node *c = Getattr(n, "sym:overloaded"); c; c = Getattr(c, "sym:nextSibling")) {
+    if (Getattr(c, "error") || !Getattr(c, "wrap:name"))
+      continue;
+    Parm *p = Getattr(c, "wrap:parms");
+    while (p) {
+      if (checkAttribute(p, "tmap:in:numinputs", "0")) {
+	p = Getattr(p, "tmap:in:next");
+	continue;
+      }
+      if (Getattr(p, "tmap:typecheck")) {
+	String *precedence = Getattr(p, "tmap:typecheck:precedence");
+	if (!precedence || !(Equal(precedence, "0") || Equal(precedence, "10")))
+	  return false;
+	if (Getattr(p, "implicitconv"))
+	  return false;
+      }
+      Parm *pk = Getattr(p, "tmap:in:next");
+      if (pk)
+	p = pk;
+      else
+	p = nextSibling(p);
+    }
+  }
+  return true;
+}
+
+/* -----------------------------------------------------------------------------
+ * dispatch_cache_store()
+ *
+ * Code remembering that the candidate with the given index was chosen.
+ * ----------------------------------------------------------------------------- */
+
+static String *dispatch_cache_store(int index, int maxargs) {
+  String *f = NewString("");
+  Printf(f, "swig_dispatch_index = %d;\n", index);
+  Printf(f, "swig_dispatch_argc = (int)%s;\n", argc_template_string);
+  for (int k = 0; k < maxargs; k++) {
+    String *arg = NewStringf(argv_template_string, k);
+    String *id = NewStringf(typeid_template_string, arg);
+    Printf(f, "swig_dispatch_types[%d] = %s > %d ? %s : 0;\n", k, argc_template_string, k, id);
+    Delete(id);
+    Delete(arg);
+  }
+  return f;
+}
+
 String *Swig_overload_dispatch(Node *n, const_String_or_char_ptr fmt, int *maxargs, const_String_or_char_ptr fmt_fastdispatch) {
 
-  if (fast_dispatch_mode || GetFlag(n, "feature:fastdispatch")) {
+  /* The dispatch cache needs every candidate to be fully checked before it is chosen */
+  bool cache = (dispatch_cache_mode || GetFlag(n, "feature:dispatchcache")) && dispatch_cache_possible(n);
+
+  if (!cache && (switch_dispatch_mode || GetFlag(n, "feature:switchdispatch"))) {
+    return overload_dispatch_switch(n, fmt, maxargs, fmt_fastdispatch);
+  }
+
+  if (!cache && (fast_dispatch_mode || GetFlag(n, "feature:fastdispatch"))) {
     return overload_dispatch_fast(n, fmt, maxargs, fmt_fastdispatch);
   }
 
@@ -787,6 +1028,18 @@ String *Swig_overload_dispatch(Node *n, const_String_or_char_ptr fmt, int *maxar
   List *dispatch = Swig_overload_rank(n, true);
   int nfunc = Len(dispatch);
 
+  String *cached = 0;
+  if (cache) {
+    for (i = 0; i < nfunc; i++) {
+      int num_arguments = emit_num_arguments(Getattr(Getitem(dispatch, i), "wrap:parms"));
+      if (GetFlag(n, "wrap:this"))
+	num_arguments++;
+      if (num_arguments > *maxargs)
+	*maxargs = num_arguments;
+    }
+    cached = NewString("");
+  }
+
   /* Loop over the functions */
 
   for (i = 0; i < nfunc; i++) {
@@ -823,6 +1076,11 @@ String *Swig_overload_dispatch(Node *n, const_String_or_char_ptr fmt, int *maxar
       if (j >= num_required) {
 	String *lfmt = ReplaceFormat(fmt, num_arguments);
 	Printf(f, "if (%s <= %d) {\n", argc_template_string, j);
+	if (cache) {
+	  String *store = dispatch_cache_store(i, *maxargs);
+	  Printv(f, store, NIL);
+	  Delete(store);
+	}
 	Printf(f, Char(lfmt), Getattr(ni, "wrap:name"));
 	Printf(f, "}\n");
 	Delete(lfmt);
@@ -845,6 +1103,14 @@ String *Swig_overload_dispatch(Node *n, const_String_or_char_ptr fmt, int *maxar
       j++;
     }
     String *lfmt = ReplaceFormat(fmt, num_arguments);
+    if (cache) {
+      String *store = dispatch_cache_store(i, *maxargs);
+      Printv(f, store, NIL);
+      Delete(store);
+      Printf(cached, "case %d:\n", i);
+      Printf(cached, Char(lfmt), Getattr(ni, "wrap:name"));
+      Printf(cached, "\nbreak;\n");
+    }
     Printf(f, Char(lfmt), Getattr(ni, "wrap:name"));
     Delete(lfmt);
     /* close braces */
@@ -854,6 +1120,34 @@ String *Swig_overload_dispatch(Node *n, const_String_or_char_ptr fmt, int *maxar
     if (implicitconvtypecheckoff)
       Delattr(ni, "implicitconvtypecheckoff");
   }
+
+  if (cache) {
+    /* Try the candidate chosen by the previous call first if the arguments have the same types */
+    String *cascade = f;
+    f = NewString("{\n");
+    Printf(f, "static int swig_dispatch_index = -1;\n");
+    Printf(f, "static int swig_dispatch_argc = 0;\n");
+    Printf(f, "static void *swig_dispatch_types[%d];\n", *maxargs);
+    Printf(f, "if (swig_dispatch_index >= 0 && %s == swig_dispatch_argc", argc_template_string);
+    for (int k = 0; k < *maxargs; k++) {
+      String *arg = NewStringf(argv_template_string, k);
+      String *id = NewStringf(typeid_template_string, arg);
+      Printf(f, "\n && (%s > %d ? %s : 0) == swig_dispatch_types[%d]", argc_template_string, k, id, k);
+      Delete(id);
+      Delete(arg);
+    }
+    Printf(f, ") {\n");
+    Printf(f, "switch (swig_dispatch_index) {\n");
+    Printv(f, cached, NIL);
+    Printf(f, "default:\n");
+    Printf(f, "break;\n");
+    Printf(f, "}\n");
+    Printf(f, "}\n");
+    Printv(f, cascade, NIL);
+    Printf(f, "}\n");
+    Delete(cascade);
+    Delete(cached);
+  }
   Delete(dispatch);
   return f;
 }
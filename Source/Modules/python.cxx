@@ -35,6 +35,7 @@ static String *global_name = 0;
 static int shadow = 1;
 static int use_kw = 0;
 static int director_method_index = 0;
+static List *director_method_names = 0;
 static int builtin = 0;
 
 static File *f_begin = 0;
@@ -53,6 +54,7 @@ static String *f_shadow_after_begin = 0;
 static String *f_shadow_stubs = 0;
 static Hash *builtin_getset = 0;
 static Hash *builtin_closures = 0;
+static Hash *fastcall_wrappers = 0;
 static Hash *class_members = 0;
 static File *f_builtins = 0;
 static String *builtin_tp_init = 0;
@@ -80,18 +82,33 @@ static String *real_classname;
 /* Thread Support */
 static int threads = 0;
 static int nothreads = 0;
+static int gil_threads = 0;	/* Thread support for the functions releasing the GIL with %feature("nogil") only */
 
 /* Other options */
 static int dirvtable = 0;
+static int dirbypass = 0;
 static int doxygen = 0;
 static int fastunpack = 1;
 static int fastproxy = 0;
+static int fastcall = 0;
 static int olddefs = 0;
 static int castmode = 0;
 static int extranative = 0;
 static int nortti = 0;
 static int relativeimport = 0;
 
+/* Split output (-shards) */
+static int shards = 0;
+static String *f_begin_code = 0;
+static File *f_wrappers_main = 0;
+static String *methods_main = 0;
+static String *methods_proxydocs_main = 0;
+static List *shard_wrappers = 0;
+static List *shard_methods = 0;
+static List *shard_methods_proxydocs = 0;
+static Hash *shard_functions = 0;
+static int shard_current = -1;
+
 /* flags for the make_autodoc function */
 enum autodoc_t {
   AUTODOC_CLASS,
@@ -111,9 +128,11 @@ Python Options (available with -python)\n\
      -castmode       - Enable the casting mode, which allows implicit cast between types in Python\n\
      -debug-doxygen-parser     - Display doxygen parser module debugging information\n\
      -debug-doxygen-translator - Display doxygen translator module debugging information\n\
+     -dirbypass      - Call the C++ base directly from director methods not overridden in Python\n\
      -dirvtable      - Generate a pseudo virtual table for directors for faster dispatch\n\
      -doxygen        - Convert C++ doxygen comments to pydoc comments in proxy classes\n\
      -extranative    - Return extra native wrappers for C++ std containers wherever possible\n\
+     -fastcall       - Use METH_FASTCALL to pass function arguments without a tuple (Python 3.7+)\n\
      -fastproxy      - Use fast proxy mechanism for member methods\n\
      -globals <name> - Set <name> used to access C global variable (default: 'cvar')\n\
      -interface <mod>- Set low-level C/C++ module name to <mod> (default: module name prefixed by '_')\n\
@@ -128,6 +147,7 @@ static const char *usage3 = "\
      -olddefs        - Keep the old method definitions when using -fastproxy\n\
      -py3            - Generate code with Python 3 specific features and syntax\n\
      -relativeimport - Use relative Python imports\n\
+     -shards <n>     - Also write the wrapper functions split across <n> files for parallel compilation\n\
      -threads        - Add thread support for all the interface\n\
      -O              - Enable the following optimization options:\n\
                          -fastdispatch -fastproxy -fvirtual\n\
@@ -230,11 +250,55 @@ public:
    * Thread Implementation
    * ------------------------------------------------------------ */
   int threads_enable(Node *n) const {
-    return threads && !GetFlagAttr(n, "feature:nothread");
+    return (threads || gil_threads) && !GetFlagAttr(n, "feature:nothread");
+  }
+
+  /* Whether %feature("nogil") or %feature("gil", "release") is used anywhere from n */
+  static int gil_released_in(Node *n) {
+    for (Node *c = n; c; c = nextSibling(c)) {
+      String *gil = Getattr(c, "feature:gil");
+      if (GetFlag(c, "feature:nogil") || (gil && Equal(gil, "release")))
+	return 1;
+      if (gil_released_in(firstChild(c)))
+	return 1;
+    }
+    return 0;
+  }
+
+  /* Getters of variables of a type other than a class, whose wrappers only read a value */
+  static int plain_getter(Node *n) {
+    return (GetFlag(n, "memberget") || GetFlag(n, "varget")) && !classLookup(Getattr(n, "type"));
+  }
+
+  /* ------------------------------------------------------------
+   * gil_release()
+   *
+   * Whether the wrapper of n releases the GIL around the wrapped call.  The
+   * nothread, gil and nogil features of the declaration come first, then those
+   * of its class and -threads.  %feature("gil", "keep_accessors") keeps the GIL
+   * in the getters of variables of other types than classes.
+   * ------------------------------------------------------------ */
+
+  int gil_release(Node *n) {
+    if (GetFlagAttr(n, "feature:nothread"))
+      return 0;
+    String *gil = Getattr(n, "feature:gil");
+    if (gil && Equal(gil, "keep"))
+      return 0;
+    if ((gil && Equal(gil, "release")) || GetFlag(n, "feature:nogil"))
+      return 1;
+    Node *cls = getCurrentClass();
+    String *cls_gil = cls ? Getattr(cls, "feature:gil") : 0;
+    if (cls_gil && Equal(cls_gil, "keep"))
+      return 0;
+    int release = threads || (cls && ((cls_gil && Equal(cls_gil, "release")) || GetFlag(cls, "feature:nogil")));
+    if (release && ((gil && Equal(gil, "keep_accessors")) || (cls_gil && Equal(cls_gil, "keep_accessors"))))
+      return !plain_getter(n);
+    return release;
   }
 
   int initialize_threads(String *f_init) {
-    if (!threads) {
+    if (!threads && !gil_threads) {
       return SWIG_OK;
     }
     Printf(f_init, "\n");
@@ -299,6 +363,7 @@ public:
   virtual void main(int argc, char *argv[]) {
 
     SWIG_library_directory("python");
+    typeid_template_string = NewString("SWIG_Python_TypeId(%s)");
 
     int doxygen_translator_flags = 0;
 
@@ -346,6 +411,9 @@ public:
 	} else if (strcmp(argv[i], "-dirvtable") == 0) {
 	  dirvtable = 1;
 	  Swig_mark_arg(i);
+	} else if (strcmp(argv[i], "-dirbypass") == 0) {
+	  dirbypass = 1;
+	  Swig_mark_arg(i);
 	} else if (strcmp(argv[i], "-doxygen") == 0) {
 	  doxygen = 1;
 	  scan_doxygen_comments = 1;
@@ -362,6 +430,9 @@ public:
 	} else if (strcmp(argv[i], "-fastproxy") == 0) {
 	  fastproxy = 1;
 	  Swig_mark_arg(i);
+	} else if (strcmp(argv[i], "-fastcall") == 0) {
+	  fastcall = 1;
+	  Swig_mark_arg(i);
 	} else if (strcmp(argv[i], "-olddefs") == 0) {
 	  olddefs = 1;
 	  Swig_mark_arg(i);
@@ -400,6 +471,19 @@ public:
 	} else if (strcmp(argv[i], "-relativeimport") == 0) {
 	  relativeimport = 1;
 	  Swig_mark_arg(i);
+	} else if (strcmp(argv[i], "-shards") == 0) {
+	  if (argv[i + 1]) {
+	    shards = atoi(argv[i + 1]);
+	    if (shards < 1) {
+	      Printf(stderr, "Invalid number of shards: %s.\n", argv[i + 1]);
+	      SWIG_exit(EXIT_FAILURE);
+	    }
+	    Swig_mark_arg(i);
+	    Swig_mark_arg(i + 1);
+	    i++;
+	  } else {
+	    Swig_arg_error();
+	  }
 	} else if (strcmp(argv[i], "-cppcast") == 0 ||
 		   strcmp(argv[i], "-fastinit") == 0 ||
 		   strcmp(argv[i], "-fastquery") == 0 ||
@@ -444,6 +528,11 @@ public:
       }
     }
 
+    if (shards && builtin) {
+      Printf(stderr, "The -shards option cannot be used with -builtin.\n");
+      SWIG_exit(EXIT_FAILURE);
+    }
+
     if (doxygen)
       doxygenTranslator = new PyDocConverter(doxygen_translator_flags);
 
@@ -540,6 +629,7 @@ public:
     f_directors = NewString("");
     builtin_getset = NewHash();
     builtin_closures = NewHash();
+    fastcall_wrappers = NewHash();
     builtin_closures_code = NewString("");
     class_members = NewHash();
     builtin_methods = NewString("");
@@ -574,6 +664,30 @@ public:
     methods = NewString("");
     methods_proxydocs = NewString("");
 
+    f_wrappers_main = f_wrappers;
+    methods_main = methods;
+    methods_proxydocs_main = methods_proxydocs;
+    if (shards) {
+      /* %begin code is repeated at the top of each shard, so collect it first */
+      f_begin_code = NewString("");
+      Swig_register_filebyname("begin", f_begin_code);
+      shard_wrappers = NewList();
+      shard_methods = NewList();
+      shard_methods_proxydocs = NewList();
+      shard_functions = NewHash();
+      for (int i = 0; i < shards; i++) {
+	String *wrappers = NewString("#ifdef __cplusplus\nextern \"C\" {\n#endif\n");
+	String *shard_methods_i = NewString("");
+	String *shard_methods_proxydocs_i = NewString("");
+	Append(shard_wrappers, wrappers);
+	Append(shard_methods, shard_methods_i);
+	Append(shard_methods_proxydocs, shard_methods_proxydocs_i);
+	Delete(wrappers);
+	Delete(shard_methods_i);
+	Delete(shard_methods_proxydocs_i);
+      }
+    }
+
     Swig_banner(f_begin);
 
     Printf(f_runtime, "\n\n#ifndef SWIGPYTHON\n#define SWIGPYTHON\n#endif\n\n");
@@ -582,12 +696,17 @@ public:
       Printf(f_runtime, "#define SWIG_DIRECTORS\n");
     }
 
+    gil_threads = !threads && !nothreads && gil_released_in(firstChild(n));
     if (nothreads) {
       Printf(f_runtime, "#define SWIG_PYTHON_NO_THREADS\n");
-    } else if (threads) {
+    } else if (threads || gil_threads) {
       Printf(f_runtime, "#define SWIG_PYTHON_THREADS\n");
     }
 
+    if (fastcall) {
+      Printf(f_runtime, "#define SWIG_PYTHON_FASTCALL\n");
+    }
+
     if (!dirvtable) {
       Printf(f_runtime, "#define SWIG_PYTHON_DIRECTOR_NO_VTABLE\n");
     }
@@ -611,6 +730,10 @@ public:
       Printf(f_runtime, "#define SWIGPYTHON_BUILTIN\n");
     }
 
+    if (shards) {
+      Printf(f_runtime, "#define SWIG_SHARDS %d\n", shards);
+    }
+
     Printf(f_runtime, "\n");
 
     Printf(f_header, "#ifdef SWIG_TypeQuery\n");
@@ -806,6 +929,23 @@ public:
     Append(methods_proxydocs, "};\n");
     Printf(f_wrappers, "%s\n", methods_proxydocs);
 
+    if (shards) {
+      /* The method tables of the shards are added to the module by SWIG_init */
+      for (int i = 1; i <= shards; i++) {
+	Printf(f_wrappers, "extern PyMethodDef SwigMethods_%s_%d[];\n", module, i);
+	Printf(f_wrappers, "extern PyMethodDef SwigMethods_proxydocs_%s_%d[];\n", module, i);
+      }
+      Printf(f_wrappers, "static PyMethodDef *SwigMethods_shards[] = {\n");
+      for (int i = 1; i <= shards; i++)
+	Printf(f_wrappers, "  SwigMethods_%s_%d,\n", module, i);
+      Printf(f_wrappers, "  NULL\n};\n");
+      Printf(f_wrappers, "static PyMethodDef *SwigMethods_proxydocs_shards[] = {\n");
+      for (int i = 1; i <= shards; i++)
+	Printf(f_wrappers, "  SwigMethods_proxydocs_%s_%d,\n", module, i);
+      Printf(f_wrappers, "  NULL\n};\n\n");
+      SwigType_type_table_shared(module);
+    }
+
     if (builtin) {
       Dump(f_builtins, f_wrappers);
     }
@@ -870,6 +1010,8 @@ public:
     }
 
     /* Close all of the files */
+    if (shards)
+      Printv(f_begin, f_begin_code, NIL);
     Dump(f_runtime, f_begin);
     Dump(f_header, f_begin);
 
@@ -887,6 +1029,9 @@ public:
       Printf(f_begin, "static PyTypeObject *builtin_bases[%d];\n\n", max_bases + 2);
     Wrapper_pretty_print(f_init, f_begin);
 
+    if (shards)
+      emitShards(outfile, outfile_h);
+
     Delete(default_import_code);
     Delete(f_shadow_after_begin);
     Delete(f_shadow_imports);
@@ -904,6 +1049,91 @@ public:
     return SWIG_OK;
   }
 
+  /* ------------------------------------------------------------
+   * shardEnter()
+   *
+   * Send the wrapper code and method table entries to one of the
+   * shards (-shards) until shardLeave(). A new key, or no key, picks
+   * the shard with the least code so far; a key seen before (the
+   * name of overloaded functions) picks the same shard again.
+   * Returns 0 if not splitting the output or already in a shard.
+   * ------------------------------------------------------------ */
+
+  int shardEnter(String *key) {
+    if (!shards || shard_current >= 0)
+      return 0;
+    String *index = key ? Getattr(shard_functions, key) : 0;
+    int k = 0;
+    if (index) {
+      k = atoi(Char(index));
+    } else {
+      for (int i = 1; i < shards; i++) {
+	if (Len(Getitem(shard_wrappers, i)) < Len(Getitem(shard_wrappers, k)))
+	  k = i;
+      }
+      if (key) {
+	index = NewStringf("%d", k);
+	Setattr(shard_functions, key, index);
+	Delete(index);
+      }
+    }
+    shardSwitch(k);
+    return 1;
+  }
+
+  void shardLeave() {
+    shardSwitch(-1);
+  }
+
+  void shardSwitch(int k) {
+    shard_current = k;
+    f_wrappers = k >= 0 ? Getitem(shard_wrappers, k) : f_wrappers_main;
+    methods = k >= 0 ? Getitem(shard_methods, k) : methods_main;
+    methods_proxydocs = k >= 0 ? Getitem(shard_methods_proxydocs, k) : methods_proxydocs_main;
+    Swig_register_filebyname("wrapper", f_wrappers);
+  }
+
+  /* ------------------------------------------------------------
+   * emitShards()
+   *
+   * Write the shards as outfile_1.cxx ... outfile_<n>.cxx. Each one
+   * repeats the runtime and header code of the main file and defines
+   * SWIG_SHARD, so that the type table is only declared, followed by
+   * its wrappers and their method table.
+   * ------------------------------------------------------------ */
+
+  void emitShards(String *outfile, String *outfile_h) {
+    String *base = Swig_file_basename(outfile);
+    String *ext = Swig_file_extension(outfile);
+    for (int i = 0; i < shards; i++) {
+      String *filename = NewStringf("%s_%d%s", base, i + 1, ext);
+      File *f_shard = NewFile(filename, "w", SWIG_output_files());
+      if (!f_shard) {
+	FileErrorDisplay(filename);
+	SWIG_exit(EXIT_FAILURE);
+      }
+      Swig_banner(f_shard);
+      Printv(f_shard, f_begin_code, NIL);
+      Printf(f_shard, "\n#define SWIG_SHARD %d\n", i + 1);
+      Printv(f_shard, f_runtime, f_header, NIL);
+      if (directorsEnabled() && outfile_h) {
+	String *header = Swig_file_filename(outfile_h);
+	Printf(f_shard, "\n#include \"%s\"\n\n", header);
+	Delete(header);
+      }
+      Printv(f_shard, Getitem(shard_wrappers, i), NIL);
+      Printf(f_shard, "PyMethodDef SwigMethods_%s_%d[] = {\n", module, i + 1);
+      Printv(f_shard, Getitem(shard_methods, i), "\t { NULL, NULL, 0, NULL }\n};\n\n", NIL);
+      Printf(f_shard, "PyMethodDef SwigMethods_proxydocs_%s_%d[] = {\n", module, i + 1);
+      Printv(f_shard, Getitem(shard_methods_proxydocs, i), "\t { NULL, NULL, 0, NULL }\n};\n\n", NIL);
+      Printf(f_shard, "#ifdef __cplusplus\n}\n#endif\n");
+      Delete(f_shard);
+      Delete(filename);
+    }
+    Delete(ext);
+    Delete(base);
+  }
+
   /* ------------------------------------------------------------
    * Emit the wrapper for PyInstanceMethod_New to MethodDef array.
    * This wrapper is used to implement -fastproxy,
@@ -2425,6 +2655,83 @@ public:
 	&& !GetFlag(n, "memberset") && !GetFlag(n, "memberget");
   }
 
+  /* ------------------------------------------------------------
+   * check_fastcall()
+   *
+   * Whether a wrapper taking a variable number of arguments can be a
+   * METH_FASTCALL|METH_KEYWORDS function (-fastcall).  Builtin constructors,
+   * slots and comparison operators keep the signatures they are called with.
+   * ------------------------------------------------------------ */
+
+  int check_fastcall(Node *n, bool builtin_ctor) const {
+    if (!fastcall)
+      return 0;
+    if (builtin && (builtin_ctor || Getattr(n, "feature:python:slot") || Getattr(n, "feature:python:compare")))
+      return 0;
+    return 1;
+  }
+
+  /* ------------------------------------------------------------
+   * add_builtin_method()
+   *
+   * Adds the method table entry of a builtin class member once n has been
+   * wrapped.  Overloaded methods are added with the last overload, when the
+   * dispatch function and its signature are known.
+   * ------------------------------------------------------------ */
+
+  void add_builtin_method(Node *n) {
+    if (Getattr(n, "sym:nextSibling"))
+      return;
+    String *symname = Getattr(n, "sym:name");
+    Node *member = Getattr(class_members, symname);
+    Node *overloaded = Getattr(n, "sym:overloaded");
+    if (!member || (member != n && (!overloaded || Getattr(member, "sym:overloaded") != overloaded)))
+      return;
+
+    String *fullname = Swig_name_member(NSPACE_TODO, class_name, symname);
+    String *wname = Swig_name_wrapper(fullname);
+    int argcount = Getattr(member, "python:argcount") ? atoi(Char(Getattr(member, "python:argcount"))) : 2;
+    if (GetFlag(member, "python:staticmethod")) {
+      int funpack = fastunpack && !overloaded;
+      String *pyflags = NewString("METH_STATIC|");
+      if (funpack && argcount == 0)
+	Append(pyflags, "METH_NOARGS");
+      else if (funpack && argcount == 1)
+	Append(pyflags, "METH_O");
+      else if (Getattr(fastcall_wrappers, wname))
+	Append(pyflags, "METH_FASTCALL|METH_KEYWORDS");
+      else
+	Append(pyflags, "METH_VARARGS");
+      // Cast via void(*)(void) to suppress GCC -Wcast-function-type warning.
+      // Python should always call the function correctly, but the Python C
+      // API requires us to store it in function pointer of a different type.
+      String *ds = have_docstring(member) ? cdocstring(member, AUTODOC_STATICFUNC) : NewString("");
+      Printf(builtin_methods, "  { \"%s\", (PyCFunction)(void(*)(void))%s, %s, \"%s\" },\n", symname, wname, pyflags, ds);
+      Delete(ds);
+      Delete(pyflags);
+    } else {
+      String *ds = have_docstring(member) ? cdocstring(member, AUTODOC_METHOD) : NewString("");
+      if (check_kwargs(member)) {
+	// Cast via void(*)(void) to suppress GCC -Wcast-function-type
+	// warning.  Python should always call the function correctly, but
+	// the Python C API requires us to store it in function pointer of a
+	// different type.
+	Printf(builtin_methods, "  { \"%s\", (PyCFunction)(void(*)(void))%s, METH_VARARGS|METH_KEYWORDS, \"%s\" },\n", symname, wname, ds);
+      } else if (argcount == 0) {
+	Printf(builtin_methods, "  { \"%s\", %s, METH_NOARGS, \"%s\" },\n", symname, wname, ds);
+      } else if (argcount == 1) {
+	Printf(builtin_methods, "  { \"%s\", %s, METH_O, \"%s\" },\n", symname, wname, ds);
+      } else if (Getattr(fastcall_wrappers, wname)) {
+	Printf(builtin_methods, "  { \"%s\", (PyCFunction)(void(*)(void))%s, METH_FASTCALL|METH_KEYWORDS, \"%s\" },\n", symname, wname, ds);
+      } else {
+	Printf(builtin_methods, "  { \"%s\", %s, METH_VARARGS, \"%s\" },\n", symname, wname, ds);
+      }
+      Delete(ds);
+    }
+    Delete(fullname);
+    Delete(wname);
+  }
+
 
 
   /* ------------------------------------------------------------
@@ -2445,6 +2752,10 @@ public:
       } else {
 	Printf(meth_str, "\t { \"%s\", %s, METH_VARARGS, ", name, function);
       }
+      if (Getattr(fastcall_wrappers, function)) {
+	Clear(meth_str);
+	Printf(meth_str, "\t { \"%s\", (PyCFunction)(void(*)(void))%s, METH_FASTCALL|METH_KEYWORDS, ", name, function);
+      }
     } else {
       // Cast via void(*)(void) to suppress GCC -Wcast-function-type warning.
       // Python should always call the function correctly, but the Python C API
@@ -2529,8 +2840,14 @@ public:
     String *symname = Getattr(n, "sym:name");
     String *wname = Swig_name_wrapper(symname);
 
+    int fastcall_dispatch = funpack && fastunpack && check_fastcall(n, builtin_ctor);
     const char *builtin_kwargs = builtin_ctor ? ", PyObject *kwargs" : "";
-    Printv(f->def, linkage, builtin_ctor ? "int " : "PyObject *", wname, "(PyObject *self, PyObject *args", builtin_kwargs, ") {", NIL);
+    if (fastcall_dispatch) {
+      Printv(f->def, linkage, "PyObject *", wname, "(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {", NIL);
+      Setattr(fastcall_wrappers, wname, "1");
+    } else {
+      Printv(f->def, linkage, builtin_ctor ? "int " : "PyObject *", wname, "(PyObject *self, PyObject *args", builtin_kwargs, ") {", NIL);
+    }
 
     Wrapper_add_local(f, "argc", "Py_ssize_t argc");
     Printf(tmp, "PyObject *argv[%d] = {0}", maxargs + 1);
@@ -2559,7 +2876,10 @@ public:
     } else {
       if (builtin_ctor)
 	Printf(f->code, "if (!SWIG_Python_CheckNoKeywords(kwargs, \"%s\")) SWIG_fail;\n", symname);
-      Printf(f->code, "if (!(argc = SWIG_Python_UnpackTuple(args, \"%s\", 0, %d, argv%s))) SWIG_fail;\n", symname, maxargs, add_self ? "+1" : "");
+      if (fastcall_dispatch)
+	Printf(f->code, "if (!(argc = SWIG_Python_UnpackVector(args, nargs, kwnames, \"%s\", 0, %d, argv%s))) SWIG_fail;\n", symname, maxargs, add_self ? "+1" : "");
+      else
+	Printf(f->code, "if (!(argc = SWIG_Python_UnpackTuple(args, \"%s\", 0, %d, argv%s))) SWIG_fail;\n", symname, maxargs, add_self ? "+1" : "");
       if (add_self)
 	Append(f->code, "argv[0] = self;\n");
       else
@@ -2722,7 +3042,7 @@ public:
     outarg = NewString("");
     kwargs = NewString("");
 
-    int allow_thread = threads_enable(n);
+    int allow_thread = gil_release(n);
 
     Wrapper_add_local(f, "resultobj", "PyObject *resultobj = 0");
 
@@ -2942,6 +3262,11 @@ public:
 	  if (onearg && !builtin_ctor && !is_tp_call) {
 	    Printf(parse_args, "if (!args) SWIG_fail;\n");
 	    Append(parse_args, "swig_obj[0] = args;\n");
+	  } else if (!noargs && check_fastcall(n, builtin_ctor)) {
+	    Clear(f->def);
+	    Printv(f->def, linkage, wrap_return, wname, "(PyObject *", self_param, ", PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {", NIL);
+	    Printf(parse_args, "if (!SWIG_Python_UnpackVector(args, nargs, kwnames, \"%s\", %d, %d, swig_obj)) SWIG_fail;\n", iname, num_fixed_arguments, tuple_arguments);
+	    Setattr(fastcall_wrappers, wname, "1");
 	  } else if (!noargs) {
 	    Printf(parse_args, "if (!SWIG_Python_UnpackTuple(args, \"%s\", %d, %d, swig_obj)) SWIG_fail;\n", iname, num_fixed_arguments, tuple_arguments);
 	  } else if (noargs) {
@@ -3689,6 +4014,23 @@ public:
 
   int classDirectorMethod(Node *n, Node *parent, String *super);
 
+  /* ------------------------------------------------------------
+   * directorInitOverrides()
+   *
+   * Emit the call made by a director constructor to find out which
+   * methods the Python class overrides (-dirbypass).
+   * ------------------------------------------------------------ */
+
+  void directorInitOverrides(String *code, String *basetype) {
+    SwigType *ptype = Copy(basetype);
+    SwigType_add_pointer(ptype);
+    SwigType_remember(ptype);
+    String *mangle = SwigType_manglestr(ptype);
+    Printf(code, "   swig_init_overrides(SWIGTYPE%s); \n", mangle);
+    Delete(mangle);
+    Delete(ptype);
+  }
+
   /* ------------------------------------------------------------
    * classDirectorConstructor()
    * ------------------------------------------------------------ */
@@ -3721,6 +4063,8 @@ public:
 	call = Swig_csuperclass_call(0, basetype, superparms);
 	Printf(w->def, "%s::%s: %s, Swig::Director(self) { \n", classname, target, call);
 	Printf(w->def, "   SWIG_DIRECTOR_RGTR((%s *)this, this); \n", basetype);
+	if (dirbypass)
+	  directorInitOverrides(w->def, basetype);
 	Append(w->def, "}\n");
 	Delete(target);
 	Wrapper_print(w, f_directors);
@@ -3755,6 +4099,8 @@ public:
       Wrapper *w = NewWrapper();
       Printf(w->def, "SwigDirector_%s::SwigDirector_%s(PyObject *self) : Swig::Director(self) { \n", classname, classname);
       Printf(w->def, "   SWIG_DIRECTOR_RGTR((%s *)this, this); \n", basetype);
+      if (dirbypass)
+	directorInitOverrides(w->def, basetype);
       Append(w->def, "}\n");
       Wrapper_print(w, f_directors);
       DelWrapper(w);
@@ -3809,6 +4155,25 @@ public:
       Printf(f_directors_h, "    mutable std::map<std::string, bool> swig_inner;\n");
 
     }
+    if (dirbypass) {
+      Printf(f_directors_h, "\n");
+      Printf(f_directors_h, "/* Methods not overridden in Python call the C++ base directly */\n");
+      Printf(f_directors_h, "public:\n");
+      if (director_method_index) {
+	Printf(f_directors_h, "    void swig_init_overrides(swig_type_info *swig_type) {\n");
+	Printf(f_directors_h, "      static const char *const swig_method_names[] = {");
+	for (int i = 0; i < director_method_index; i++)
+	  Printf(f_directors_h, "%s\"%s\"", i ? ", " : "", Getitem(director_method_names, i));
+	Printf(f_directors_h, "};\n");
+	Printf(f_directors_h, "      swig_find_overrides(swig_type, swig_method_names, swig_override, %d);\n", director_method_index);
+	Printf(f_directors_h, "    }\n");
+	Printf(f_directors_h, "private:\n");
+	Printf(f_directors_h, "    bool swig_override[%d];\n", director_method_index);
+      } else {
+	Printf(f_directors_h, "    void swig_init_overrides(swig_type_info *) {\n");
+	Printf(f_directors_h, "    }\n");
+      }
+    }
     if (director_method_index) {
       Printf(f_directors_h, "\n");
       Printf(f_directors_h, "#if defined(SWIG_PYTHON_DIRECTOR_VTABLE)\n");
@@ -4076,6 +4441,8 @@ public:
     String *tp_init = NewString(builtin_tp_init ? Char(builtin_tp_init) : Swig_directorclass(n) ? "0" : "SwigPyBuiltin_BadInit");
     String *tp_flags = NewString("Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE|Py_TPFLAGS_CHECKTYPES");
     String *tp_flags_py3 = NewString("Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE");
+    if (Getattr(n, "feature:python:bf_getbuffer"))
+      Append(tp_flags, "|Py_TPFLAGS_HAVE_NEWBUFFER");
 
     static String *tp_basicsize = NewStringf("sizeof(SwigPyObject)");
     static String *tp_dictoffset_default = NewString("offsetof(SwigPyObject, dict)");
@@ -4319,7 +4686,7 @@ public:
       Printf(clientdata_klass, "(PyObject *) &%s_type", templ);
     }
 
-    Printf(f, "SWIGINTERN SwigPyClientData %s_clientdata = {%s, 0, 0, 0, 0, 0, (PyTypeObject *)&%s_type};\n\n", templ, clientdata_klass, templ);
+    Printf(f, "SWIGINTERN SwigPyClientData %s_clientdata = {%s, 0, 0, 0, 0, 0, (PyTypeObject *)&%s_type, 0, 0};\n\n", templ, clientdata_klass, templ);
 
     Printv(f_init, "    if (PyType_Ready(builtin_pytype) < 0) {\n", NIL);
     Printf(f_init, "      PyErr_SetString(PyExc_TypeError, \"Could not create type '%s'.\");\n", symname);
@@ -4502,7 +4869,10 @@ public:
       Printv(none_comparison, "$arg != Py_None", NIL);
     }
 
+    int in_shard = shardEnter(0);
     Language::classHandler(n);
+    if (in_shard)
+      shardLeave();
 
     in_class = 0;
 
@@ -4526,8 +4896,21 @@ public:
 	Printv(f_wrappers, "  PyObject *obj;\n", NIL);
 	Printv(f_wrappers, "  if (!SWIG_Python_UnpackTuple(args, \"swigregister\", 1, 1, &obj)) return NULL;\n", NIL);
 
-	Printv(f_wrappers,
-	       "  SWIG_TypeNewClientData(SWIGTYPE", SwigType_manglestr(ct), ", SWIG_NewClientData(obj));\n", "  return SWIG_Py_Void();\n", "}\n\n", NIL);
+	Printv(f_wrappers, "  SWIG_TypeNewClientData(SWIGTYPE", SwigType_manglestr(ct), ", SWIG_NewClientData(obj));\n", NIL);
+	String *getbuffer = Getattr(n, "feature:python:bf_getbuffer");
+	String *releasebuffer = Getattr(n, "feature:python:bf_releasebuffer");
+	if (getbuffer || releasebuffer) {
+	  /* The 'this' objects export the buffer of the instances, see SwigPyObject_getbuffer */
+	  String *mangled = SwigType_manglestr(ct);
+	  Printv(f_wrappers, "  if (SWIGTYPE", mangled, "->clientdata) {\n", NIL);
+	  if (getbuffer)
+	    Printv(f_wrappers, "    ((SwigPyClientData *)SWIGTYPE", mangled, "->clientdata)->getbuffer = (getbufferproc) ", getbuffer, ";\n", NIL);
+	  if (releasebuffer)
+	    Printv(f_wrappers, "    ((SwigPyClientData *)SWIGTYPE", mangled, "->clientdata)->releasebuffer = (releasebufferproc) ", releasebuffer, ";\n", NIL);
+	  Printv(f_wrappers, "  }\n", NIL);
+	  Delete(mangled);
+	}
+	Printv(f_wrappers, "  return SWIG_Py_Void();\n", "}\n\n", NIL);
 	String *cname = NewStringf("%s_swigregister", class_name);
 	add_method(cname, cname, 0, 0, 1, 1, 1);
 	Delete(cname);
@@ -4547,6 +4930,10 @@ public:
 	add_method(cname, cname, 0);
 	Delete(cname);
       }
+      if (!builtin && Getattr(n, "feature:python:bf_getbuffer")) {
+	/* Python 3.12 and later use __buffer__ for the buffer protocol of classes defined in Python */
+	Printv(f_shadow_file, tab4, "def __buffer__(self, flags):\n", tab8, "return memoryview(self.this)\n", NIL);
+      }
       if (!have_repr && !builtin) {
 	/* Supply a repr method for this class  */
 	String *rname = SwigType_namestr(real_classname);
@@ -4608,6 +4995,24 @@ public:
     return Language::functionHandler(n);
   }
 
+  /* ------------------------------------------------------------
+   * globalfunctionHandler()  -  Places the function in a shard
+   * ------------------------------------------------------------ */
+
+  virtual int globalfunctionHandler(Node *n) {
+    /* Overloads of friend functions can be in several classes, so not in the shard of the class */
+    int shard = shard_current;
+    if (shard >= 0)
+      shardLeave();
+    int in_shard = shardEnter(Getattr(n, "sym:name"));
+    int result = Language::globalfunctionHandler(n);
+    if (in_shard)
+      shardLeave();
+    if (shard >= 0)
+      shardSwitch(shard);
+    return result;
+  }
+
   /* ------------------------------------------------------------
    * memberfunctionHandler()
    * ------------------------------------------------------------ */
@@ -4630,28 +5035,10 @@ public:
       // Can't use checkAttribute(n, "access", "public") because
       // "access" attr isn't set on %extend methods
       if (!checkAttribute(n, "access", "private") && strncmp(Char(symname), "operator ", 9) && !Getattr(class_members, symname)) {
-	String *fullname = Swig_name_member(NSPACE_TODO, class_name, symname);
-	String *wname = Swig_name_wrapper(fullname);
 	Setattr(class_members, symname, n);
-	int argcount = Getattr(n, "python:argcount") ? atoi(Char(Getattr(n, "python:argcount"))) : 2;
-	String *ds = have_docstring(n) ? cdocstring(n, AUTODOC_METHOD) : NewString("");
-	if (check_kwargs(n)) {
-	  // Cast via void(*)(void) to suppress GCC -Wcast-function-type
-	  // warning.  Python should always call the function correctly, but
-	  // the Python C API requires us to store it in function pointer of a
-	  // different type.
-	  Printf(builtin_methods, "  { \"%s\", (PyCFunction)(void(*)(void))%s, METH_VARARGS|METH_KEYWORDS, \"%s\" },\n", symname, wname, ds);
-	} else if (argcount == 0) {
-	  Printf(builtin_methods, "  { \"%s\", %s, METH_NOARGS, \"%s\" },\n", symname, wname, ds);
-	} else if (argcount == 1) {
-	  Printf(builtin_methods, "  { \"%s\", %s, METH_O, \"%s\" },\n", symname, wname, ds);
-	} else {
-	  Printf(builtin_methods, "  { \"%s\", %s, METH_VARARGS, \"%s\" },\n", symname, wname, ds);
-	}
-	Delete(fullname);
-	Delete(wname);
-	Delete(ds);
+	Delattr(n, "python:staticmethod");
       }
+      add_builtin_method(n);
     }
 
     if (builtin)
@@ -4730,32 +5117,10 @@ public:
     if (builtin && in_class) {
       if ((GetFlagAttr(n, "feature:extend") || checkAttribute(n, "access", "public"))
 	  && !Getattr(class_members, symname)) {
-	String *fullname = Swig_name_member(NSPACE_TODO, class_name, symname);
-	String *wname = Swig_name_wrapper(fullname);
 	Setattr(class_members, symname, n);
-	int funpack = fastunpack && !Getattr(n, "sym:overloaded");
-	String *pyflags = NewString("METH_STATIC|");
-	int argcount = Getattr(n, "python:argcount") ? atoi(Char(Getattr(n, "python:argcount"))) : 2;
-	if (funpack && argcount == 0)
-	  Append(pyflags, "METH_NOARGS");
-	else if (funpack && argcount == 1)
-	  Append(pyflags, "METH_O");
-	else
-	  Append(pyflags, "METH_VARARGS");
-	// Cast via void(*)(void) to suppress GCC -Wcast-function-type warning.
-	// Python should always call the function correctly, but the Python C
-	// API requires us to store it in function pointer of a different type.
-	if (have_docstring(n)) {
-	  String *ds = cdocstring(n, AUTODOC_STATICFUNC);
-	  Printf(builtin_methods, "  { \"%s\", (PyCFunction)(void(*)(void))%s, %s, \"%s\" },\n", symname, wname, pyflags, ds);
-	  Delete(ds);
-	} else {
-	  Printf(builtin_methods, "  { \"%s\", (PyCFunction)(void(*)(void))%s, %s, \"\" },\n", symname, wname, pyflags);
-	}
-	Delete(fullname);
-	Delete(wname);
-	Delete(pyflags);
+	SetFlag(n, "python:staticmethod");
       }
+      add_builtin_method(n);
       return SWIG_OK;
     }
 
@@ -5022,16 +5387,17 @@ public:
    * ------------------------------------------------------------ */
 
   virtual int staticmembervariableHandler(Node *n) {
+    /* The variable is linked in SWIG_init, so its wrappers stay in the main file */
+    int shard = shard_current;
+    if (shard >= 0)
+      shardLeave();
     Swig_save("builtin_staticmembervariableHandler", n, "builtin_symname", NIL);
     Language::staticmembervariableHandler(n);
     Swig_restore(n);
 
-    if (GetFlag(n, "wrappedasconstant"))
-      return SWIG_OK;
-
     String *symname = Getattr(n, "sym:name");
 
-    if (shadow) {
+    if (shadow && !GetFlag(n, "wrappedasconstant")) {
       if (!builtin && GetFlag(n, "hasconsttype")) {
 	String *mname = Swig_name_member(NSPACE_TODO, class_name, symname);
 	Printf(f_shadow_stubs, "%s.%s = %s.%s.%s\n", class_name, symname, module, global_name, mname);
@@ -5103,6 +5469,8 @@ public:
 	Delete(varsetname);
       }
     }
+    if (shard >= 0)
+      shardSwitch(shard);
     return SWIG_OK;
   }
 
@@ -5224,6 +5592,8 @@ public:
  * --------------------------------------------------------------- */
 int PYTHON::classDirectorMethods(Node *n) {
   director_method_index = 0;
+  Delete(director_method_names);
+  director_method_names = NewList();
   return Language::classDirectorMethods(n);
 }
 
@@ -5355,6 +5725,18 @@ int PYTHON::classDirectorMethod(Node *n, Node *parent, String *super) {
 	     SwigType_namestr(name));
     }
   } else {
+    /* call the C++ base directly if the Python class does not override the method */
+    if (dirbypass && !pure_virtual) {
+      Printf(w->code, "if (!swig_override[%d]) {\n", director_method_index);
+      String *super_call = Swig_method_call(super, l);
+      if (is_void)
+	Printf(w->code, "%s;\nreturn;\n", super_call);
+      else
+	Printf(w->code, "return %s;\n", super_call);
+      Append(w->code, "}\n");
+      Delete(super_call);
+    }
+
     /* attach typemaps to arguments (C/C++ -> Python) */
     String *arglist = NewString("");
     String *parse_args = NewString("");
@@ -5519,6 +5901,7 @@ int PYTHON::classDirectorMethod(Node *n, Node *parent, String *super) {
     Printf(w->code, "  Swig::DirectorException::raise(\"'self' uninitialized, maybe you forgot to call %s.__init__.\");\n", classname);
     Append(w->code, "}\n");
     Append(w->code, "#if defined(SWIG_PYTHON_DIRECTOR_VTABLE)\n");
+    Append(director_method_names, pyname);
     Printf(w->code, "const size_t swig_method_index = %d;\n", director_method_index++);
     Printf(w->code, "const char *const swig_method_name = \"%s\";\n", pyname);
 
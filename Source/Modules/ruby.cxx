@@ -837,6 +837,7 @@ public:
 
     /* Set location of SWIG library */
     SWIG_library_directory("ruby");
+    typeid_template_string = NewString("(void *)CLASS_OF(%s)");
 
     /* Look for certain command line options */
     for (int i = 1; i < argc; i++) {
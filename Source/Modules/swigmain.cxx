@@ -18,6 +18,12 @@
 
 #include "swigmod.h"
 #include <ctype.h>
+#include <errno.h>
+#if !defined(_WIN32)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 /* Module factories.  These functions are used to instantiate
    the built-in language modules.    If adding a new language
@@ -153,7 +159,7 @@ static void insert_option(int *argc, char ***argv, int index, char const *start,
   *argv = new_argv;
 }
 
-static void merge_options_files(int *argc, char ***argv) {
+static void merge_options_files(int *argc, char ***argv, int *env_end) {
   static const int BUFFER_SIZE = 4096;
   char buffer[BUFFER_SIZE];
   int i;
@@ -170,6 +176,7 @@ static void merge_options_files(int *argc, char ***argv) {
       char *be = &buffer[BUFFER_SIZE];
       int quote = 0;
       bool escape = false;
+      int old_argc = new_argc;
 
       new_argc--;
       memmove(&new_argv[i], &new_argv[i + 1], sizeof(char *) * (new_argc - i));
@@ -205,6 +212,8 @@ static void merge_options_files(int *argc, char ***argv) {
       if (b != buffer)
         insert_option(&new_argc, &new_argv, insert, buffer, b);
       fclose(f);
+      if (i < *env_end)
+        *env_end += new_argc - old_argc;
     } else {
       ++i;
     }
@@ -214,15 +223,135 @@ static void merge_options_files(int *argc, char ***argv) {
   *argc = new_argc;
 }
 
+//-----------------------------------------------------------------
+// run_languages()
+//
+// Generates the wrappers for several target languages from one command
+// line with -multilang, each in its own process with the languages running
+// concurrently.  A language gets the options that don't follow a target
+// language option, the options following its own option up to the next
+// target language option or the end of SWIG_FEATURES, and the input file.
+// A language given more than once gets the options following each of its
+// options.  The files for a language are written in a subdirectory named
+// after it, unless its own options include -o, -oh or -outdir, which then
+// replace the same option given for all the languages.
+//-----------------------------------------------------------------
+
+static bool is_output_option(const char *arg) {
+  return strcmp(arg, "-o") == 0 || strcmp(arg, "-oh") == 0 || strcmp(arg, "-outdir") == 0;
+}
+
+static int run_languages(int argc, char **argv, int env_end, const TargetLanguageModule **languages, const int *language_args, int nlanguages) {
+#if defined(_WIN32)
+  (void)argc;
+  (void)argv;
+  (void)env_end;
+  (void)languages;
+  (void)language_args;
+  (void)nlanguages;
+  Printf(stderr, "Generating wrappers for several target languages at once is not supported on this platform.\n");
+  return EXIT_FAILURE;
+#else
+  int res = EXIT_SUCCESS;
+  pid_t *pids = (pid_t *)malloc(sizeof(pid_t) * nlanguages);
+
+  /* The language each option applies to, -1 for all the languages */
+  const TargetLanguageModule **owners = (const TargetLanguageModule **)malloc(sizeof(TargetLanguageModule *) * argc);
+  const TargetLanguageModule *owner = 0;
+  for (int i = 1, k = 0; i < argc - 1; i++) {
+    if (i == env_end)
+      owner = 0;
+    if (k < nlanguages && language_args[k] == i)
+      owner = languages[k++];
+    owners[i] = owner;
+  }
+
+  fflush(stdout);
+  fflush(stderr);
+  for (int k = 0; k < nlanguages; k++) {
+    pids[k] = 0;
+    bool seen = false;
+    for (int l = 0; l < k; l++) {
+      if (languages[l] == languages[k])
+	seen = true;
+    }
+    if (seen)
+      continue;
+
+    char **largv = (char **)malloc(sizeof(char *) * (argc + 1));
+    int largc = 0;
+    bool own_output = false;
+    largv[largc++] = argv[0];
+    for (int i = 1; i < argc - 1; i++) {
+      if (owners[i] || strcmp(argv[i], "-multilang") == 0)
+	continue;
+      if (is_output_option(argv[i])) {
+	bool replaced = false;
+	for (int j = 1; j < argc - 1; j++) {
+	  if (owners[j] == languages[k] && strcmp(argv[j], argv[i]) == 0)
+	    replaced = true;
+	}
+	if (replaced) {
+	  /* Replaced by the same option among the language's own options */
+	  if (i + 1 < argc - 1 && !owners[i + 1])
+	    i++;
+	  continue;
+	}
+      }
+      largv[largc++] = argv[i];
+    }
+    int language_arg = largc;
+    largv[largc++] = argv[language_args[k]];
+    for (int i = 1; i < argc - 1; i++) {
+      if (owners[i] != languages[k] || strcmp(argv[i], "-multilang") == 0 || strcmp(argv[i], languages[k]->name) == 0)
+	continue;
+      if (is_output_option(argv[i]))
+	own_output = true;
+      largv[largc++] = argv[i];
+    }
+    largv[largc++] = argv[argc - 1];
+    largv[largc] = 0;
+
+    pids[k] = fork();
+    if (pids[k] == 0) {
+      Swig_init_args(largc, largv);
+      Swig_mark_arg(language_arg);
+      if (!own_output)
+	SWIG_output_subdirectory(languages[k]->name + 1);
+      exit(SWIG_main(largc, largv, languages[k]));
+    }
+    free(largv);
+    if (pids[k] < 0) {
+      Printf(stderr, "Unable to start SWIG for %s: %s\n", languages[k]->name, strerror(errno));
+      res = EXIT_FAILURE;
+    }
+  }
+
+  for (int k = 0; k < nlanguages; k++) {
+    int status;
+    if (pids[k] > 0 && (waitpid(pids[k], &status, 0) != pids[k] || !WIFEXITED(status) || WEXITSTATUS(status) != 0))
+      res = EXIT_FAILURE;
+  }
+  free(owners);
+  free(pids);
+  return res;
+#endif
+}
+
 int main(int margc, char **margv) {
   int i;
   const TargetLanguageModule *language_module = 0;
+  const TargetLanguageModule **languages;
+  int *language_args;
+  int nlanguages = 0;
+  bool multilang = false;
 
   int argc;
   char **argv;
 
   SWIG_merge_envopt(getenv("SWIG_FEATURES"), margc, margv, &argc, &argv);
-  merge_options_files(&argc, &argv);
+  int env_end = argc - margc + 1;
+  merge_options_files(&argc, &argv, &env_end);
 
 #ifdef MACSWIG
   SIOUXSettings.asktosaveonclose = false;
@@ -230,6 +359,8 @@ int main(int margc, char **margv) {
 #endif
 
   Swig_init_args(argc, argv);
+  languages = (const TargetLanguageModule **)malloc(sizeof(TargetLanguageModule *) * argc);
+  language_args = (int *)malloc(sizeof(int) * argc);
 
   /* Get options */
   for (i = 1; i < argc; i++) {
@@ -244,6 +375,8 @@ int main(int margc, char **margv) {
       }
       if (is_target_language_module) {
 	Swig_mark_arg(i);
+	languages[nlanguages] = language_module;
+	language_args[nlanguages++] = i;
 	if (language_module->status == Disabled) {
 	  if (language_module->help)
 	    Printf(stderr, "Target language option %s (%s) is no longer supported.\n", language_module->name, language_module->help);
@@ -251,6 +384,9 @@ int main(int margc, char **margv) {
 	    Printf(stderr, "Target language option %s is no longer supported.\n", language_module->name);
 	  SWIG_exit(EXIT_FAILURE);
 	}
+      } else if (strcmp(argv[i], "-multilang") == 0) {
+	Swig_mark_arg(i);
+	multilang = true;
       } else if ((strcmp(argv[i], "-help") == 0) || (strcmp(argv[i], "--help") == 0)) {
 	if (strcmp(argv[i], "--help") == 0)
 	  strcpy(argv[i], "-help");
@@ -271,7 +407,20 @@ int main(int margc, char **margv) {
     }
   }
 
-  int res = SWIG_main(argc, argv, language_module);
+  /* Several different target languages with -multilang, otherwise the last target language option wins */
+  int other_languages = 0;
+  for (i = 0; i < nlanguages; i++) {
+    if (languages[i] != language_module)
+      other_languages++;
+  }
+
+  int res;
+  if (multilang && other_languages > 0)
+    res = run_languages(argc, argv, env_end, languages, language_args, nlanguages);
+  else
+    res = SWIG_main(argc, argv, language_module);
+  free(language_args);
+  free(languages);
 
   return res;
 }
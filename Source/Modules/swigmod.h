@@ -39,6 +39,9 @@ extern int SwigRuntime;
 extern String *argv_template_string;
 extern String *argc_template_string;
 
+/* Identity of the type of an argument, for the overload dispatch cache */
+extern String *typeid_template_string;
+
 /* Miscellaneous stuff */
 
 #define  tab2   "  "
@@ -380,6 +383,7 @@ void Swig_print_xml(Node *obj, String *filename);
 List *SWIG_output_files();
 
 void SWIG_library_directory(const char *);
+void SWIG_output_subdirectory(const char *);
 int emit_num_arguments(ParmList *);
 int emit_num_required(ParmList *);
 int emit_isvarargs(ParmList *p);
@@ -417,6 +421,8 @@ int is_non_virtual_protected_access(Node *n); /* Check if the non-virtual protec
 void Wrapper_virtual_elimination_mode_set(int);
 void Wrapper_fast_dispatch_mode_set(int);
 void Wrapper_cast_dispatch_mode_set(int);
+void Wrapper_switch_dispatch_mode_set(int);
+void Wrapper_dispatch_cache_mode_set(int);
 void Wrapper_naturalvar_mode_set(int);
 
 void clean_overloaded(Node *n);
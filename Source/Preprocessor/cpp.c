@@ -28,10 +28,17 @@ static int import_all = 0;	/* Follow all includes, but as %import statements */
 static int imported_depth = 0;	/* Depth of %imported files */
 static int single_include = 1;	/* Only include each file once */
 static Hash *included_files = 0;
+static Hash *include_guards = 0;	/* Include guards of the included files, keyed by contents */
+static String *parsed_guard = 0;	/* Include guard of the last string preprocessed */
+static int parsed_once = 0;	/* Whether the last string preprocessed had #pragma once */
 static List *dependencies = 0;
 static Scanner *id_scan = 0;
 static int error_as_warning = 0;	/* Understand the cpp #error directive as a special #warning */
 static int expand_defined_operator = 0;
+static int fast_cpp = 0;	/* Use the buffer based macro replacement */
+static String *cache_dir = 0;	/* Directory of the precompiled include cache */
+static List *cache_journal = 0;	/* What the include being recorded for the cache did */
+static int cache_usable = 0;	/* Whether the include being recorded can be saved */
 static int macro_level = 0;
 static int macro_start_line = 0;
 static const String * macro_start_file = 0;
@@ -80,8 +87,74 @@ static void copy_location(const DOH *s1, DOH *s2) {
   Setline(s2, Getline((DOH *) s1));
 }
 
+/* -----------------------------------------------------------------------------
+ * cache_note()
+ *
+ * While an include is being recorded for the precompiled include cache, notes
+ * something it did to the preprocessor state.  The entry is a tag followed by
+ * a NIL terminated list of strings.
+ * ----------------------------------------------------------------------------- */
+
+static void cache_note(const char *tag, ...) {
+  va_list ap;
+  List *entry;
+  void *field;
+  if (!cache_journal)
+    return;
+  entry = NewList();
+  Append(entry, tag);
+  va_start(ap, tag);
+  while ((field = va_arg(ap, void *))) {
+    /* The strings passed in may be reused */
+    String *copy = NewString(field);
+    Append(entry, copy);
+    Delete(copy);
+  }
+  va_end(ap);
+  Append(cache_journal, entry);
+  Delete(entry);
+}
+
+/* -----------------------------------------------------------------------------
+ * cache_hash()
+ *
+ * Adds a string to a 64 bit hash, kept as two 32 bit FNV-1a and djb2 hashes.
+ * ----------------------------------------------------------------------------- */
+
+static void cache_hash(unsigned int h[2], const_String_or_char_ptr str) {
+  const unsigned char *c = (const unsigned char *) Char(str);
+  int len = Len(str);
+  int i;
+  for (i = 0; i < len; i++) {
+    h[0] = (h[0] ^ c[i]) * 16777619U;
+    h[1] = h[1] * 33 + c[i];
+  }
+  /* Separate the strings */
+  h[0] = (h[0] ^ 0xff) * 16777619U;
+  h[1] = h[1] * 33 + (unsigned int) len;
+}
+
+static String *cache_digest(const_String_or_char_ptr str) {
+  unsigned int h[2];
+  h[0] = 2166136261U;
+  h[1] = 5381;
+  cache_hash(h, str);
+  return NewStringf("%08x%08x", h[0] & 0xffffffffU, h[1] & 0xffffffffU);
+}
+
 static String *cpp_include(const_String_or_char_ptr fn, int sysfile) {
   String *s = sysfile ? Swig_include_sys(fn) : Swig_include(fn);
+  if (s) {
+    Hash *guard;
+    /* Blow away all carriage returns, as Preprocessor_parse() would */
+    Replace(s, "\015", "", DOH_REPLACE_ANY);
+    guard = Getattr(include_guards, s);
+    if (guard && GetFlag(guard, "once")) {
+      /* The same file under another name, and it has #pragma once */
+      Delete(s);
+      return 0;
+    }
+  }
   if (s && single_include) {
     String *file = Getfile(s);
     if (Getattr(included_files, file)) {
@@ -104,6 +177,11 @@ static String *cpp_include(const_String_or_char_ptr fn, int sysfile) {
     }
     lf = Copy(Swig_last_file());
     Append(dependencies, lf);
+    if (cache_journal) {
+      String *digest = cache_digest(s);
+      cache_note("file", lf, digest, NIL);
+      Delete(digest);
+    }
     Delete(lf);
   }
   return s;
@@ -211,6 +289,7 @@ void Preprocessor_init(void) {
   Delete(s);
   Preprocessor_expr_init();	/* Initialize the expression evaluator */
   included_files = NewHash();
+  include_guards = NewHash();
 
   id_scan = NewScanner();
 
@@ -255,6 +334,11 @@ void Preprocessor_delete(void) {
 
   Delete(cpp);
   Delete(included_files);
+  Delete(include_guards);
+  Delete(parsed_guard);
+  parsed_guard = 0;
+  Delete(cache_dir);
+  cache_dir = 0;
   Preprocessor_expr_delete();
   DelScanner(id_scan);
 
@@ -282,6 +366,54 @@ void Preprocessor_error_as_warning(int a) {
   error_as_warning = a;
 }
 
+void Preprocessor_fast_expansion(int a) {
+  fast_cpp = a;
+}
+
+void Preprocessor_cache_dir(const_String_or_char_ptr dir) {
+  Delete(cache_dir);
+  cache_dir = dir ? NewString(dir) : 0;
+}
+
+/* -----------------------------------------------------------------------------
+ * macro_fields()
+ *
+ * Returns a macro as a list of strings: name, value, flags, arguments, file and
+ * line.  The flags are 'a' if it takes arguments, 'v' if they are variadic and
+ * 's' for a SWIG macro.
+ * ----------------------------------------------------------------------------- */
+
+static List *macro_fields(Hash *macro) {
+  List *fields = NewList();
+  List *args = Getattr(macro, kpp_args);
+  String *flags = NewStringEmpty();
+  String *argstr = NewStringEmpty();
+  String *line = NewStringf("%d", Getline(macro));
+  if (args) {
+    int i;
+    Putc('a', flags);
+    for (i = 0; i < Len(args); i++) {
+      if (i)
+	Putc(',', argstr);
+      Append(argstr, Getitem(args, i));
+    }
+  }
+  if (Getattr(macro, kpp_varargs))
+    Putc('v', flags);
+  if (Getattr(macro, kpp_swigmacro))
+    Putc('s', flags);
+  Append(fields, Getattr(macro, kpp_name));
+  Append(fields, Getattr(macro, kpp_value));
+  Append(fields, flags);
+  Append(fields, argstr);
+  Append(fields, Getfile(macro) ? Getfile(macro) : "");
+  Append(fields, line);
+  Delete(line);
+  Delete(argstr);
+  Delete(flags);
+  return fields;
+}
+
 
 /* -----------------------------------------------------------------------------
  * Preprocessor_define()
@@ -540,6 +672,12 @@ Hash *Preprocessor_define(const_String_or_char_ptr _str, int swigmacro) {
   } else {
     Setattr(symbols, macroname, macro);
     Delete(macro);
+    if (cache_journal) {
+      List *fields = macro_fields(macro);
+      Insert(fields, 0, "define");
+      Append(cache_journal, fields);
+      Delete(fields);
+    }
   }
 
   Delete(macroname);
@@ -568,6 +706,7 @@ void Preprocessor_undef(const_String_or_char_ptr str) {
   assert(cpp);
   symbols = Getattr(cpp, kpp_symbols);
   Delattr(symbols, str);
+  cache_note("undef", str, NIL);
 }
 
 /* -----------------------------------------------------------------------------
@@ -757,6 +896,233 @@ static String *get_options(String *str) {
   }
 }
 
+/* -----------------------------------------------------------------------------
+ * macro_body()
+ *
+ * With -fastcpp the value of a macro is split up once into the pieces of text
+ * between its arguments, so that expand_macro() can assemble an expansion in a
+ * single pass instead of running a series of replacements over a copy of the
+ * value for each argument.  The pieces are kept in the macro's meta data.
+ * Macros using the non-standard `x` and #@x substitutions are not split up.
+ * ----------------------------------------------------------------------------- */
+
+#define MACRO_PIECE_TEXT      0	/* Text from the macro value */
+#define MACRO_PIECE_ARG       1	/* Argument, macro expanded */
+#define MACRO_PIECE_RAWARG    2	/* Argument, for the ## operator */
+#define MACRO_PIECE_STRINGIZE 4	/* Argument, for the # operator */
+
+typedef struct {
+  int kind;
+  int arg;			/* Argument index, or length of the text */
+  int offset;			/* Offset of the text */
+} MacroPiece;
+
+typedef struct {
+  int supported;
+  int nargs;
+  int npieces;
+  MacroPiece *pieces;
+  char *text;
+  int *uses;			/* MACRO_PIECE_ flags for each argument */
+} MacroBody;
+
+/* A character in an identifier as far as the DOH_REPLACE_ID flags are concerned */
+#define isreplacechar(c) (((unsigned char) (c) < 128) && (isalnum((unsigned char) (c)) || ((c) == '_')))
+
+static void macro_body_delete(void *ptr) {
+  MacroBody *body = (MacroBody *) ptr;
+  free(body->pieces);
+  free(body->text);
+  free(body->uses);
+  free(body);
+}
+
+static void macro_body_add(MacroBody *body, int kind, int arg, int offset) {
+  MacroPiece *piece;
+  if ((body->npieces & 15) == 0)
+    body->pieces = (MacroPiece *) realloc(body->pieces, (body->npieces + 16) * sizeof(MacroPiece));
+  piece = &body->pieces[body->npieces++];
+  piece->kind = kind;
+  piece->arg = arg;
+  piece->offset = offset;
+}
+
+/* Index of the argument named by the len characters at s, or -1 */
+static int macro_body_arg(List *margs, const char *s, int len) {
+  int i;
+  int l = Len(margs);
+  for (i = 0; i < l; i++) {
+    String *aname = Getitem(margs, i);
+    if (Len(aname) == len && strncmp(Char(aname), s, len) == 0)
+      return i;
+  }
+  return -1;
+}
+
+/* Adds the argument at s, if there is one, returning its length */
+static int macro_body_add_arg(MacroBody *body, List *margs, int kind, const char *s, const char *end, int *start, int t) {
+  const char *e = s;
+  int i;
+  while (e < end && isreplacechar(*e))
+    e++;
+  i = (e > s) ? macro_body_arg(margs, s, (int)(e - s)) : -1;
+  if (i < 0)
+    return 0;
+  if (t > *start)
+    macro_body_add(body, MACRO_PIECE_TEXT, t - *start, *start);
+  macro_body_add(body, kind, i, 0);
+  body->uses[i] |= kind;
+  *start = t;
+  return (int)(e - s);
+}
+
+static MacroBody *macro_body(Hash *macro, String *mvalue, List *margs) {
+  MacroBody *body;
+  DOH *v = Getmeta(macro, "body");
+  const char *s, *end;
+  int i, j, l, n, t, start;
+
+  if (v)
+    return (MacroBody *) Data(v);
+
+  body = (MacroBody *) calloc(1, sizeof(MacroBody));
+  v = NewVoid(body, macro_body_delete);
+  Setmeta(macro, "body", v);
+  Delete(v);
+
+  s = Char(mvalue);
+  n = Len(mvalue);
+  if ((int) strlen(s) != n || strpbrk(s, "`\003\004\005"))
+    return body;
+  l = margs ? Len(margs) : 0;
+  for (i = 0; i < l; i++) {
+    String *aname = Getitem(margs, i);
+    const char *c = Char(aname);
+    if (!*c)
+      return body;
+    for (; *c; c++) {
+      if (!isreplacechar(*c))
+	return body;
+    }
+    for (j = 0; j < i; j++) {
+      if (Equal(aname, Getitem(margs, j)))
+	return body;
+    }
+  }
+
+  /* Split the value up the same way as the replacements in expand_macro() would */
+  body->nargs = l;
+  body->uses = (int *) calloc(l + 1, sizeof(int));
+  body->text = (char *) malloc(n + 1);
+  end = s + n;
+  t = start = 0;
+  while (s < end) {
+    int c = *s;
+    if (c == '\001') {
+      int len = l ? macro_body_add_arg(body, margs, MACRO_PIECE_STRINGIZE, s + 1, end, &start, t) : 0;
+      if (len) {
+	s += 1 + len;
+      } else {
+	body->text[t++] = '#';
+	s++;
+      }
+    } else if (c == '\002') {
+      int len = l ? macro_body_add_arg(body, margs, MACRO_PIECE_RAWARG, s + 1, end, &start, t) : 0;
+      s += 1 + len;
+    } else if (isreplacechar(c)) {
+      const char *e = s;
+      while (e < end && isreplacechar(*e))
+	e++;
+      if (!l || !macro_body_add_arg(body, margs, (e < end && *e == '\002') ? MACRO_PIECE_RAWARG : MACRO_PIECE_ARG, s, end, &start, t)) {
+	memcpy(body->text + t, s, e - s);
+	t += (int)(e - s);
+      }
+      s = e;
+    } else {
+      body->text[t++] = (char) c;
+      s++;
+    }
+  }
+  if (t > start)
+    macro_body_add(body, MACRO_PIECE_TEXT, t - start, start);
+  body->supported = 1;
+  return body;
+}
+
+/* Checks whether text contains one of the arguments from index first on as an identifier */
+static int macro_body_contains_arg(List *margs, int first, String *text) {
+  const char *s = Char(text);
+  const char *end = s + Len(text);
+  while (s < end) {
+    if (isreplacechar(*s)) {
+      const char *e = s;
+      while (e < end && isreplacechar(*e))
+	e++;
+      if (macro_body_arg(margs, s, (int)(e - s)) >= first)
+	return 1;
+      s = e;
+    } else {
+      s++;
+    }
+  }
+  return 0;
+}
+
+/* -----------------------------------------------------------------------------
+ * macro_body_expand()
+ *
+ * Assembles the expansion of a macro from its pieces.  Returns NULL if the
+ * arguments could interact with the replacements made for other arguments, in
+ * which case expand_macro() falls back to making the replacements one by one.
+ * ----------------------------------------------------------------------------- */
+
+static String *macro_body_expand(MacroBody *body, String *mvalue, List *margs, List *args, List *repargs) {
+  String *ns;
+  int i;
+
+  for (i = 0; i < body->nargs; i++) {
+    String *arg = Getitem(args, i);
+    String *reparg = Getitem(repargs, i);
+    int uses = body->uses[i];
+    if (strpbrk(Char(arg), "`\001\002\003\004\005") || strpbrk(Char(reparg), "`\001\002\003\004\005"))
+      return 0;
+    if ((uses & MACRO_PIECE_STRINGIZE) && macro_body_contains_arg(margs, i, arg))
+      return 0;
+    if ((uses & MACRO_PIECE_RAWARG) && macro_body_contains_arg(margs, i + 1, arg))
+      return 0;
+    if ((uses & MACRO_PIECE_ARG) && macro_body_contains_arg(margs, i + 1, reparg))
+      return 0;
+  }
+
+  ns = NewStringEmpty();
+  for (i = 0; i < body->npieces; i++) {
+    MacroPiece *piece = &body->pieces[i];
+    String *arg;
+    switch (piece->kind) {
+    case MACRO_PIECE_TEXT:
+      Write(ns, body->text + piece->offset, piece->arg);
+      break;
+    case MACRO_PIECE_ARG:
+      arg = Getitem(repargs, piece->arg);
+      Write(ns, Char(arg), Len(arg));
+      break;
+    case MACRO_PIECE_RAWARG:
+      arg = Getitem(args, piece->arg);
+      Write(ns, Char(arg), Len(arg));
+      break;
+    case MACRO_PIECE_STRINGIZE:
+      arg = Getitem(args, piece->arg);
+      Write(ns, "\"", 1);
+      Write(ns, Char(arg), Len(arg));
+      Write(ns, "\"", 1);
+      break;
+    }
+  }
+  /* Same location as a copy of the value would have */
+  copy_location(mvalue, ns);
+  return ns;
+}
+
 /* -----------------------------------------------------------------------------
  * expand_macro()
  *
@@ -768,8 +1134,9 @@ static String *get_options(String *str) {
  * ----------------------------------------------------------------------------- */
 
 static String *expand_macro(String *name, List *args, String *line_file) {
-  String *ns;
+  String *ns = 0;
   DOH *symbols, *macro, *margs, *mvalue, *temp, *tempa, *e;
+  List *repargs = 0;
   int i, l;
   int isvarargs = 0;
 
@@ -867,125 +1234,142 @@ static String *expand_macro(String *name, List *args, String *line_file) {
     return NewString(name);
   }
 
-  /* Copy the macro value */
-  ns = Copy(mvalue);
-  copy_location(mvalue, ns);
-
-  /* Tag the macro as being expanded.   This is to avoid recursion in
-     macro expansion */
+  if (fast_cpp && Tell(mvalue) == Len(mvalue)) {
+    MacroBody *body = macro_body(macro, mvalue, margs);
+    if (body->supported) {
+      /* Expand the arguments up front, the same way as below */
+      l = (args && margs) ? Len(margs) : 0;
+      repargs = NewList();
+      for (i = 0; i < l; i++) {
+	String *reparg = Preprocessor_replace(Getitem(args, i));
+	Append(repargs, reparg);
+	Delete(reparg);
+      }
+      if (!(isvarargs && l > 0 && Len(Getitem(args, l - 1)) == 0))
+	ns = macro_body_expand(body, mvalue, margs, args, repargs);
+    }
+  }
 
   temp = NewStringEmpty();
   tempa = NewStringEmpty();
-  if (args && margs) {
-    l = Len(margs);
-    for (i = 0; i < l; i++) {
-      DOH *arg, *aname;
-      String *reparg;
-      arg = Getitem(args, i);	/* Get an argument value */
-      reparg = Preprocessor_replace(arg);
-      aname = Getitem(margs, i);	/* Get macro argument name */
-      if (strstr(Char(ns), "\001")) {
-	/* Try to replace a quoted version of the argument */
-	Clear(temp);
-	Clear(tempa);
-	Printf(temp, "\001%s", aname);
-	Printf(tempa, "\"%s\"", arg);
-	Replace(ns, temp, tempa, DOH_REPLACE_ID_END);
-      }
-      if (strstr(Char(ns), "\002")) {
-	/* Look for concatenation tokens */
-	Clear(temp);
-	Clear(tempa);
-	Printf(temp, "\002%s", aname);
-	Append(tempa, "\002\003");
-	Replace(ns, temp, tempa, DOH_REPLACE_ID_END);
-	Clear(temp);
-	Clear(tempa);
-	Printf(temp, "%s\002", aname);
-	Append(tempa, "\003\002");
-	Replace(ns, temp, tempa, DOH_REPLACE_ID_BEGIN);
-      }
-
-      /* Non-standard macro expansion.   The value `x` is replaced by a quoted
-         version of the argument except that if the argument is already quoted
-         nothing happens */
-
-      if (strchr(Char(ns), '`')) {
-	String *rep;
-	char *c;
-	Clear(temp);
-	Printf(temp, "`%s`", aname);
-	c = Char(arg);
-	if (*c == '\"') {
-	  rep = arg;
-	} else {
+  if (!ns) {
+    /* Copy the macro value */
+    ns = Copy(mvalue);
+    copy_location(mvalue, ns);
+
+    if (args && margs) {
+      l = Len(margs);
+      for (i = 0; i < l; i++) {
+	DOH *arg, *aname;
+	String *reparg;
+	arg = Getitem(args, i);	/* Get an argument value */
+	reparg = repargs ? Copy(Getitem(repargs, i)) : Preprocessor_replace(arg);
+	aname = Getitem(margs, i);	/* Get macro argument name */
+	if (strstr(Char(ns), "\001")) {
+	  /* Try to replace a quoted version of the argument */
+	  Clear(temp);
 	  Clear(tempa);
+	  Printf(temp, "\001%s", aname);
 	  Printf(tempa, "\"%s\"", arg);
-	  rep = tempa;
+	  Replace(ns, temp, tempa, DOH_REPLACE_ID_END);
+	}
+	if (strstr(Char(ns), "\002")) {
+	  /* Look for concatenation tokens */
+	  Clear(temp);
+	  Clear(tempa);
+	  Printf(temp, "\002%s", aname);
+	  Append(tempa, "\002\003");
+	  Replace(ns, temp, tempa, DOH_REPLACE_ID_END);
+	  Clear(temp);
+	  Clear(tempa);
+	  Printf(temp, "%s\002", aname);
+	  Append(tempa, "\003\002");
+	  Replace(ns, temp, tempa, DOH_REPLACE_ID_BEGIN);
 	}
-	Replace(ns, temp, rep, DOH_REPLACE_ANY);
-      }
 
-      /* Non-standard mangle expansions.  
-         The #@Name is replaced by mangle_arg(Name). */
-      if (strstr(Char(ns), "\004")) {
-	String *marg = Swig_string_mangle(arg);
-	Clear(temp);
-	Printf(temp, "\004%s", aname);
-	Replace(ns, temp, marg, DOH_REPLACE_ID_END);
-	Delete(marg);
-      }
-      if (strstr(Char(ns), "\005")) {
-	String *marg = Swig_string_mangle(arg);
-	Clear(temp);
-	Clear(tempa);
-	Printf(temp, "\005%s", aname);
-	Printf(tempa, "\"%s\"", marg);
-	Replace(ns, temp, tempa, DOH_REPLACE_ID_END);
-	Delete(marg);
-      }
+	/* Non-standard macro expansion.   The value `x` is replaced by a quoted
+	   version of the argument except that if the argument is already quoted
+	   nothing happens */
+
+	if (strchr(Char(ns), '`')) {
+	  String *rep;
+	  char *c;
+	  Clear(temp);
+	  Printf(temp, "`%s`", aname);
+	  c = Char(arg);
+	  if (*c == '\"') {
+	    rep = arg;
+	  } else {
+	    Clear(tempa);
+	    Printf(tempa, "\"%s\"", arg);
+	    rep = tempa;
+	  }
+	  Replace(ns, temp, rep, DOH_REPLACE_ANY);
+	}
+
+	/* Non-standard mangle expansions.  
+	   The #@Name is replaced by mangle_arg(Name). */
+	if (strstr(Char(ns), "\004")) {
+	  String *marg = Swig_string_mangle(arg);
+	  Clear(temp);
+	  Printf(temp, "\004%s", aname);
+	  Replace(ns, temp, marg, DOH_REPLACE_ID_END);
+	  Delete(marg);
+	}
+	if (strstr(Char(ns), "\005")) {
+	  String *marg = Swig_string_mangle(arg);
+	  Clear(temp);
+	  Clear(tempa);
+	  Printf(temp, "\005%s", aname);
+	  Printf(tempa, "\"%s\"", marg);
+	  Replace(ns, temp, tempa, DOH_REPLACE_ID_END);
+	  Delete(marg);
+	}
 
-      if (isvarargs && i == l - 1 && Len(arg) == 0) {
-	/* Zero length varargs macro argument.   We search for commas that might appear before and nuke them */
-	char *a, *s, *t, *name;
-	int namelen;
-	s = Char(ns);
-	name = Char(aname);
-	namelen = Len(aname);
-	a = strstr(s, name);
-	while (a) {
-	  char ca = a[namelen];
-	  if (!isidchar((int) ca)) {
-	    /* Matched the entire vararg name, not just a prefix */
-	    if (a > s) {
-	      t = a - 1;
-	      if (*t == '\002') {
-		t--;
-		while (t >= s) {
-		  if (isspace((int) *t))
-		    t--;
-		  else if (*t == ',') {
-		    *t = ' ';
-		  } else
-		    break;
+	if (isvarargs && i == l - 1 && Len(arg) == 0) {
+	  /* Zero length varargs macro argument.   We search for commas that might appear before and nuke them */
+	  char *a, *s, *t, *name;
+	  int namelen;
+	  s = Char(ns);
+	  name = Char(aname);
+	  namelen = Len(aname);
+	  a = strstr(s, name);
+	  while (a) {
+	    char ca = a[namelen];
+	    if (!isidchar((int) ca)) {
+	      /* Matched the entire vararg name, not just a prefix */
+	      if (a > s) {
+		t = a - 1;
+		if (*t == '\002') {
+		  t--;
+		  while (t >= s) {
+		    if (isspace((int) *t))
+		      t--;
+		    else if (*t == ',') {
+		      *t = ' ';
+		    } else
+		      break;
+		  }
 		}
 	      }
 	    }
+	    a = strstr(a + namelen, name);
 	  }
-	  a = strstr(a + namelen, name);
 	}
+	/*      Replace(ns, aname, arg, DOH_REPLACE_ID); */
+	Replace(ns, aname, reparg, DOH_REPLACE_ID);	/* Replace expanded args */
+	Replace(ns, "\003", arg, DOH_REPLACE_ANY);	/* Replace unexpanded arg */
+	Delete(reparg);
       }
-      /*      Replace(ns, aname, arg, DOH_REPLACE_ID); */
-      Replace(ns, aname, reparg, DOH_REPLACE_ID);	/* Replace expanded args */
-      Replace(ns, "\003", arg, DOH_REPLACE_ANY);	/* Replace unexpanded arg */
-      Delete(reparg);
     }
+    Replace(ns, "\002", "", DOH_REPLACE_ANY);	/* Get rid of concatenation tokens */
+    Replace(ns, "\001", "#", DOH_REPLACE_ANY);	/* Put # back (non-standard C) */
+    Replace(ns, "\004", "#@", DOH_REPLACE_ANY);	/* Put # back (non-standard C) */
   }
-  Replace(ns, "\002", "", DOH_REPLACE_ANY);	/* Get rid of concatenation tokens */
-  Replace(ns, "\001", "#", DOH_REPLACE_ANY);	/* Put # back (non-standard C) */
-  Replace(ns, "\004", "#@", DOH_REPLACE_ANY);	/* Put # back (non-standard C) */
+  Delete(repargs);
 
-  /* Expand this macro even further */
+  /* Expand this macro even further.  Tag the macro as being expanded to
+     avoid recursion in macro expansion */
   Setattr(macro, kpp_expanded, "1");
 
   e = Preprocessor_replace(ns);
@@ -1025,6 +1409,263 @@ static String *expand_macro(String *name, List *args, String *line_file) {
   return e;
 }
 
+/* -----------------------------------------------------------------------------
+ * replace_identifier()
+ *
+ * Handles an identifier id found by Preprocessor_replace() in s, which is
+ * positioned just after it, appending its replacement to ns.  Macros taking
+ * arguments read them from s.
+ * ----------------------------------------------------------------------------- */
+
+static void replace_identifier(DOH *s, DOH *ns, String *id, DOH *symbols) {
+  DOH *m;
+  int c, i;
+
+  /* See if this is the special "defined" operator */
+  if (Equal(kpp_defined, id)) {
+    if (expand_defined_operator) {
+      int lenargs = 0;
+      DOH *args = 0;
+      /* See whether or not a parenthesis has been used */
+      skip_whitespace(s, 0);
+      c = Getc(s);
+      if (c == '(') {
+	Ungetc(c, s);
+	args = find_args(s, 0, kpp_defined);
+      } else if (isidchar(c)) {
+	DOH *arg = NewStringEmpty();
+	args = NewList();
+	Putc(c, arg);
+	while (((c = Getc(s)) != EOF)) {
+	  if (!isidchar(c)) {
+	    Ungetc(c, s);
+	    break;
+	  }
+	  Putc(c, arg);
+	}
+	if (Len(arg))
+	  Append(args, arg);
+	Delete(arg);
+      } else {
+	Seek(s, -1, SEEK_CUR);
+      }
+      lenargs = Len(args);
+      if ((!args) || (!lenargs)) {
+	/* This is not a defined() operator. */
+	Append(ns, id);
+	return;
+      }
+      for (i = 0; i < lenargs; i++) {
+	DOH *o = Getitem(args, i);
+	if (!Getattr(symbols, o)) {
+	  break;
+	}
+      }
+      if (i < lenargs)
+	Putc('0', ns);
+      else
+	Putc('1', ns);
+      Delete(args);
+    } else {
+      Append(ns, id);
+    }
+  } else if (Equal(kpp_LINE, id)) {
+    Printf(ns, "%d", macro_level > 0 ? macro_start_line : Getline(s));
+  } else if (Equal(kpp_FILE, id)) {
+    String *fn = Copy(macro_level > 0 ? macro_start_file : Getfile(s));
+    Replaceall(fn, "\\", "\\\\");
+    Printf(ns, "\"%s\"", fn);
+    Delete(fn);
+  } else if (Equal(kpp_hash_if, id) || Equal(kpp_hash_elif, id)) {
+    expand_defined_operator = 1;
+    Append(ns, id);
+    /*
+  } else if (Equal("%#if", id) || Equal("%#ifdef", id)) {
+    Swig_warning(998, Getfile(s), Getline(s), "Found: %s preprocessor directive.\n", id);
+    Append(ns, id);
+  } else if (Equal("#ifdef", id) || Equal("#ifndef", id)) {
+    Swig_warning(998, Getfile(s), Getline(s), "The %s preprocessor directive does not work in macros, try #if instead.\n", id);
+    Append(ns, id);
+    */
+  } else if ((m = Getattr(symbols, id))) {
+    /* See if the macro is defined in the preprocessor symbol table */
+    DOH *args = 0;
+    DOH *e;
+    int macro_additional_lines = 0;
+    /* See if the macro expects arguments */
+    if (Getattr(m, kpp_args)) {
+      /* Yep.  We need to go find the arguments and do a substitution */
+      int line = Getline(s);
+      args = find_args(s, 1, id);
+      macro_additional_lines = Getline(s) - line;
+      assert(macro_additional_lines >= 0);
+    } else {
+      args = 0;
+    }
+    e = expand_macro(id, args, s);
+    if (e) {
+      Append(ns, e);
+    }
+    while (macro_additional_lines--) {
+      Putc('\n', ns);
+    }
+    Delete(e);
+    Delete(args);
+  } else {
+    Append(ns, id);
+  }
+}
+
+/* -----------------------------------------------------------------------------
+ * replace_final_identifier()
+ *
+ * Handles an identifier id found by Preprocessor_replace() at the end of s.
+ * ----------------------------------------------------------------------------- */
+
+static void replace_final_identifier(DOH *s, DOH *ns, String *id, DOH *symbols) {
+  /* See if this is the special "defined" operator */
+  if (Equal(kpp_defined, id)) {
+    Swig_error(Getfile(s), Getline(s), "No arguments given to defined()\n");
+  } else if (Equal(kpp_LINE, id)) {
+    Printf(ns, "%d", macro_level > 0 ? macro_start_line : Getline(s));
+  } else if (Equal(kpp_FILE, id)) {
+    String *fn = Copy(macro_level > 0 ? macro_start_file : Getfile(s));
+    Replaceall(fn, "\\", "\\\\");
+    Printf(ns, "\"%s\"", fn);
+    Delete(fn);
+  } else if (Getattr(symbols, id)) {
+    DOH *e;
+    /* Yes.  There is a macro here */
+    /* See if the macro expects arguments */
+    e = expand_macro(id, 0, s);
+    if (e)
+      Append(ns, e);
+    Delete(e);
+  } else {
+    Append(ns, id);
+  }
+}
+
+/* -----------------------------------------------------------------------------
+ * replace_fast()
+ *
+ * Preprocessor_replace() for -fastcpp.  Rather than copying s a character at a
+ * time, it scans its buffer directly and copies the text between the macros and
+ * special identifiers in one go.  These are handled as usual with s positioned
+ * after them, scanning then resumes where they ended.  The output is the same.
+ * ----------------------------------------------------------------------------- */
+
+/* Append the text from b to e, which has lines newlines, to ns */
+static void append_text(DOH *ns, const char *b, const char *e, int lines) {
+  if (e > b) {
+    Write(ns, b, (int)(e - b));
+    if (lines)
+      Setline(ns, Getline(ns) + lines);
+  }
+}
+
+static DOH *replace_fast(DOH *s, DOH *symbols) {
+  DOH *ns;
+  String *id = NewStringEmpty();
+  const char *base, *p, *end, *text;
+  int line, text_line;
+
+  ns = NewStringEmpty();
+  copy_location(s, ns);
+  Seek(s, 0, SEEK_SET);
+  line = Getline(s);
+
+  base = Char(s);
+  end = base + Len(s);
+  p = text = base;
+  text_line = line;
+  while (p < end) {
+    int c = (unsigned char) *p;
+    if (isidentifier(c) || (c == '%') || (c == '#')) {
+      const char *b = p++;
+      if ((c == '%') && (p < end) && (*p == '#'))
+	p++;
+      while ((p < end) && isidchar((unsigned char) *p))
+	p++;
+      Clear(id);
+      Write(id, b, (int)(p - b));
+      if (Getattr(symbols, id) || Equal(kpp_defined, id) || Equal(kpp_LINE, id) || Equal(kpp_FILE, id) ||
+	  (p < end && (Equal(kpp_hash_if, id) || Equal(kpp_hash_elif, id)))) {
+	append_text(ns, text, b, line - text_line);
+	Seek(s, (long)(p - base), SEEK_SET);
+	Setline(s, line);
+	if (p < end) {
+	  replace_identifier(s, ns, id, symbols);
+	  p = base + Tell(s);
+	  line = Getline(s);
+	} else {
+	  replace_final_identifier(s, ns, id, symbols);
+	}
+	text = p;
+	text_line = line;
+      }
+    } else if ((c == '\"') || (c == '\'')) {
+      /* Skip to the end of the string or character literal */
+      p++;
+      while (p < end) {
+	int cc = *p++;
+	if (cc == '\n')
+	  line++;
+	if (cc == c)
+	  break;
+	if ((cc == '\\') && (p < end)) {
+	  if (*p++ == '\n')
+	    line++;
+	}
+      }
+    } else if (c == '/') {
+      p++;
+      if ((p < end) && (*p == '/')) {
+	/* C++ comment */
+	while (++p < end) {
+	  if (*p == '\n') {
+	    p++;
+	    line++;
+	    expand_defined_operator = 0;
+	    break;
+	  }
+	}
+      } else if ((p < end) && (*p == '*')) {
+	/* C comment */
+	p++;
+	while (p < end) {
+	  int cc = *p++;
+	  if (cc == '\n') {
+	    line++;
+	  } else if (cc == '*') {
+	    while ((p < end) && (*p == '*'))
+	      p++;
+	    if ((p < end) && (*p == '/')) {
+	      p++;
+	      break;
+	    }
+	  }
+	}
+      }
+    } else if (c == '\\') {
+      p++;
+      if ((p < end) && (*p == '\n')) {
+	p++;
+	line++;
+      }
+    } else {
+      p++;
+      if (c == '\n') {
+	line++;
+	expand_defined_operator = 0;
+      }
+    }
+  }
+  append_text(ns, text, p, line - text_line);
+  Delete(id);
+  return ns;
+}
+
 /* -----------------------------------------------------------------------------
  * DOH *Preprocessor_replace(DOH *s)
  *
@@ -1037,13 +1678,17 @@ static String *expand_macro(String *name, List *args, String *line_file) {
 /* #define SWIG_PUT_BUFF  */
 
 static DOH *Preprocessor_replace(DOH *s) {
-  DOH *ns, *symbols, *m;
-  int c, i, state = 0;
-  String *id = NewStringEmpty();
+  DOH *ns, *symbols;
+  int c, state = 0;
+  String *id;
 
   assert(cpp);
   symbols = Getattr(cpp, kpp_symbols);
 
+  if (fast_cpp)
+    return replace_fast(s, symbols);
+
+  id = NewStringEmpty();
   ns = NewStringEmpty();
   copy_location(s, ns);
   Seek(s, 0, SEEK_SET);
@@ -1105,106 +1750,7 @@ static DOH *Preprocessor_replace(DOH *s) {
       } else {
 	/* We found the end of a valid identifier */
 	Ungetc(c, s);
-	/* See if this is the special "defined" operator */
-       	if (Equal(kpp_defined, id)) {
-	  if (expand_defined_operator) {
-	    int lenargs = 0;
-	    DOH *args = 0;
-	    /* See whether or not a parenthesis has been used */
-	    skip_whitespace(s, 0);
-	    c = Getc(s);
-	    if (c == '(') {
-	      Ungetc(c, s);
-	      args = find_args(s, 0, kpp_defined);
-	    } else if (isidchar(c)) {
-	      DOH *arg = NewStringEmpty();
-	      args = NewList();
-	      Putc(c, arg);
-	      while (((c = Getc(s)) != EOF)) {
-		if (!isidchar(c)) {
-		  Ungetc(c, s);
-		  break;
-		}
-		Putc(c, arg);
-	      }
-	      if (Len(arg))
-		Append(args, arg);
-	      Delete(arg);
-	    } else {
-	      Seek(s, -1, SEEK_CUR);
-	    }
-	    lenargs = Len(args);
-	    if ((!args) || (!lenargs)) {
-	      /* This is not a defined() operator. */
-	      Append(ns, id);
-	      state = 0;
-	      break;
-	    }
-	    for (i = 0; i < lenargs; i++) {
-	      DOH *o = Getitem(args, i);
-	      if (!Getattr(symbols, o)) {
-		break;
-	      }
-	    }
-	    if (i < lenargs)
-	      Putc('0', ns);
-	    else
-	      Putc('1', ns);
-	    Delete(args);
-	  } else {
-	    Append(ns, id);
-	  }
-	  state = 0;
-	  break;
-	} else if (Equal(kpp_LINE, id)) {
-	  Printf(ns, "%d", macro_level > 0 ? macro_start_line : Getline(s));
-	  state = 0;
-	  break;
-	} else if (Equal(kpp_FILE, id)) {
-	  String *fn = Copy(macro_level > 0 ? macro_start_file : Getfile(s));
-	  Replaceall(fn, "\\", "\\\\");
-	  Printf(ns, "\"%s\"", fn);
-	  Delete(fn);
-	  state = 0;
-	  break;
-	} else if (Equal(kpp_hash_if, id) || Equal(kpp_hash_elif, id)) {
-	  expand_defined_operator = 1;
-	  Append(ns, id);
-	  /*
-	} else if (Equal("%#if", id) || Equal("%#ifdef", id)) {
-	  Swig_warning(998, Getfile(s), Getline(s), "Found: %s preprocessor directive.\n", id);
-	  Append(ns, id);
-	} else if (Equal("#ifdef", id) || Equal("#ifndef", id)) {
-	  Swig_warning(998, Getfile(s), Getline(s), "The %s preprocessor directive does not work in macros, try #if instead.\n", id);
-	  Append(ns, id);
-	  */
-	} else if ((m = Getattr(symbols, id))) {
-	  /* See if the macro is defined in the preprocessor symbol table */
-	  DOH *args = 0;
-	  DOH *e;
-	  int macro_additional_lines = 0;
-	  /* See if the macro expects arguments */
-	  if (Getattr(m, kpp_args)) {
-	    /* Yep.  We need to go find the arguments and do a substitution */
-	    int line = Getline(s);
-	    args = find_args(s, 1, id);
-	    macro_additional_lines = Getline(s) - line;
-	    assert(macro_additional_lines >= 0);
-	  } else {
-	    args = 0;
-	  }
-	  e = expand_macro(id, args, s);
-	  if (e) {
-	    Append(ns, e);
-	  }
-	  while (macro_additional_lines--) {
-	    Putc('\n', ns);
-	  }
-	  Delete(e);
-	  Delete(args);
-	} else {
-	  Append(ns, id);
-	}
+	replace_identifier(s, ns, id, symbols);
 	state = 0;
       }
       break;
@@ -1249,27 +1795,7 @@ static DOH *Preprocessor_replace(DOH *s) {
 
   /* Identifier at the end */
   if (state == 2 || state == 4) {
-    /* See if this is the special "defined" operator */
-    if (Equal(kpp_defined, id)) {
-      Swig_error(Getfile(s), Getline(s), "No arguments given to defined()\n");
-    } else if (Equal(kpp_LINE, id)) {
-      Printf(ns, "%d", macro_level > 0 ? macro_start_line : Getline(s));
-    } else if (Equal(kpp_FILE, id)) {
-      String *fn = Copy(macro_level > 0 ? macro_start_file : Getfile(s));
-      Replaceall(fn, "\\", "\\\\");
-      Printf(ns, "\"%s\"", fn);
-      Delete(fn);
-    } else if (Getattr(symbols, id)) {
-      DOH *e;
-      /* Yes.  There is a macro here */
-      /* See if the macro expects arguments */
-      e = expand_macro(id, 0, s);
-      if (e)
-	Append(ns, e);
-      Delete(e);
-    } else {
-      Append(ns, id);
-    }
+    replace_final_identifier(s, ns, id, symbols);
   }
   Delete(id);
   return ns;
@@ -1331,6 +1857,370 @@ static void add_chunk(DOH *ns, DOH *chunk, int allow) {
   Clear(chunk);
 }
 
+/* -----------------------------------------------------------------------------
+ * include_parse()
+ *
+ * Preprocesses the contents s of an included file.  When a file is wrapped in
+ * an include guard, that is #ifndef GUARD ... #endif with nothing else but
+ * comments and whitespace outside, this is noted.  Including a file with the
+ * same contents when the guard macro is defined always gives the same result,
+ * so this is only worked out once.
+ * ----------------------------------------------------------------------------- */
+
+static String *include_parse(String *s) {
+  Hash *guard = Getattr(include_guards, s);
+  String *name = guard ? Getattr(guard, "name") : 0;
+  String *ns;
+
+  if (name && Getattr(Getattr(cpp, kpp_symbols), name)) {
+    ns = Getattr(guard, "skipped");
+    if (ns)
+      return Copy(ns);
+    ns = Preprocessor_parse(s);
+    Setattr(guard, "skipped", ns);
+    return ns;
+  }
+
+  ns = Preprocessor_parse(s);
+  if (parsed_once) {
+    /* Not for the cache, as including it under another name does nothing */
+    cache_usable = 0;
+  }
+  if (!guard && (parsed_guard || parsed_once)) {
+    guard = NewHash();
+    if (parsed_guard)
+      Setattr(guard, "name", parsed_guard);
+    if (parsed_once)
+      SetFlag(guard, "once");
+    Setattr(include_guards, s, guard);
+    Delete(guard);
+  }
+  return ns;
+}
+
+/* -----------------------------------------------------------------------------
+ * Precompiled include cache
+ *
+ * When a cache directory is set, the preprocessed output of each file included
+ * from the top level or from the main input file is saved there as a .swigpch
+ * file, along with the journal of what preprocessing it did to the
+ * preprocessor state (see cache_note()): macros defined and undefined, files
+ * included and #pragma SWIG settings.  The entry is named by a hash of all that
+ * the output depends on: the file itself, the options, the include path and
+ * the macros defined and files included so far.  It is only used again while
+ * none of the files it read have changed.  Includes giving any warnings or
+ * errors are not saved, so that these are always reported.
+ *
+ * A .swigpch file is a list of entries, each a line with a tag and the number
+ * of strings following it, then each string as its length, a ':', the string
+ * and a newline.
+ * ----------------------------------------------------------------------------- */
+
+/* Command line option symbols (see install_opts() in main.cxx) only saying where
+   output goes, which are left out of the key so that the cache can be shared */
+static const char *cache_output_options[] = {
+  "SWIGOPT_O", "SWIGOPT_OH", "SWIGOPT_OUTDIR", "SWIGOPT_MF", "SWIGOPT_MT", "SWIGOPT_CPPCACHE", "SWIGOPT_CHANGEDFILES",
+  "SWIGOPT_PROFILE", "SWIGOPT_PROFILE_TRACE", 0
+};
+
+static String *cache_key(String *s) {
+  Hash *symbols = Getattr(cpp, kpp_symbols);
+  List *path = Swig_search_path();
+  List *keys;
+  String *options;
+  Iterator ki;
+  unsigned int h[2];
+
+  h[0] = 2166136261U;
+  h[1] = 5381;
+  cache_hash(h, "SWIG " PACKAGE_VERSION);
+  cache_hash(h, Getfile(s));
+  cache_hash(h, s);
+  options = NewStringf("%d %d %d %d", include_all, import_all, ignore_missing, error_as_warning);
+  cache_hash(h, options);
+  Delete(options);
+  for (ki = First(path); ki.item; ki = Next(ki)) {
+    cache_hash(h, ki.item);
+  }
+  Delete(path);
+
+  keys = Keys(symbols);
+  SortList(keys, 0);
+  for (ki = First(keys); ki.item; ki = Next(ki)) {
+    /* The name, value, flags and arguments, but not where it was defined */
+    List *fields;
+    int i;
+    for (i = 0; cache_output_options[i]; i++) {
+      if (Equal(ki.item, cache_output_options[i]))
+	break;
+    }
+    if (cache_output_options[i])
+      continue;
+    fields = macro_fields(Getattr(symbols, ki.item));
+    for (i = 0; i < 4; i++) {
+      cache_hash(h, Getitem(fields, i));
+    }
+    Delete(fields);
+  }
+  Delete(keys);
+
+  keys = Keys(included_files);
+  SortList(keys, 0);
+  for (ki = First(keys); ki.item; ki = Next(ki)) {
+    cache_hash(h, ki.item);
+  }
+  Delete(keys);
+
+  return NewStringf("%s%s%08x%08x.swigpch", cache_dir, SWIG_FILE_DELIMITER, h[0] & 0xffffffffU, h[1] & 0xffffffffU);
+}
+
+static void cache_write_entry(String *data, List *entry) {
+  int i;
+  Printf(data, "%s %d\n", Getitem(entry, 0), Len(entry) - 1);
+  for (i = 1; i < Len(entry); i++) {
+    String *field = Getitem(entry, i);
+    Printf(data, "%d:", Len(field));
+    Append(data, field);
+    Putc('\n', data);
+  }
+}
+
+static void cache_save(String *cachefile, String *output) {
+  String *tmpfile = NewStringf("%s.tmp", cachefile);
+  String *data = NewString("SWIGPCH " PACKAGE_VERSION "\n");
+  String *digest;
+  List *entry;
+  Iterator ji;
+  FILE *f;
+
+  for (ji = First(cache_journal); ji.item; ji = Next(ji)) {
+    cache_write_entry(data, ji.item);
+  }
+  entry = NewList();
+  Append(entry, "output");
+  Append(entry, output);
+  cache_write_entry(data, entry);
+  Delete(entry);
+
+  /* End with a digest of the rest, so that a partly written file is never used */
+  entry = NewList();
+  Append(entry, "end");
+  digest = cache_digest(data);
+  Append(entry, digest);
+  cache_write_entry(data, entry);
+  Delete(digest);
+  Delete(entry);
+
+  f = fopen(Char(tmpfile), "wb");
+  if (f) {
+    size_t written = fwrite(Char(data), 1, (size_t) Len(data), f);
+    if (fclose(f) == 0 && written == (size_t) Len(data)) {
+      if (rename(Char(tmpfile), Char(cachefile)) != 0) {
+	/* Another run saved the same entry meanwhile */
+	remove(Char(tmpfile));
+      }
+    } else {
+      remove(Char(tmpfile));
+    }
+  }
+  Delete(data);
+  Delete(tmpfile);
+}
+
+/* Reads back a .swigpch file as a list of entries, or returns 0 if it is not complete */
+static List *cache_read(String *cachefile) {
+  static const char header[] = "SWIGPCH " PACKAGE_VERSION "\n";
+  FILE *f = fopen(Char(cachefile), "rb");
+  String *data;
+  List *entries;
+  char buffer[4096];
+  const char *start;
+  const char *c;
+  const char *end;
+  size_t n;
+  int complete = 0;
+
+  if (!f)
+    return 0;
+  data = NewStringEmpty();
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+    Write(data, buffer, (int) n);
+  }
+  fclose(f);
+
+  entries = NewList();
+  start = Char(data);
+  end = start + Len(data);
+  if (strncmp(start, header, sizeof(header) - 1) == 0) {
+    c = start + sizeof(header) - 1;
+    while (c < end && !complete) {
+      const char *tag = c;
+      List *entry;
+      String *field;
+      char *next;
+      long nfields;
+      while (c < end && *c != ' ')
+	c++;
+      if (c == end)
+	break;
+      nfields = strtol(c + 1, &next, 10);
+      if (next == end || *next != '\n')
+	break;
+      entry = NewList();
+      field = NewStringWithSize(tag, (int) (c - tag));
+      Append(entry, field);
+      Delete(field);
+      c = next + 1;
+      for (; nfields > 0; nfields--) {
+	long len = strtol(c, &next, 10);
+	if (next == end || *next != ':' || len < 0 || len + 2 > end - next)
+	  break;
+	field = NewStringWithSize(next + 1, (int) len);
+	Append(entry, field);
+	Delete(field);
+	c = next + len + 2;
+      }
+      if (nfields > 0) {
+	Delete(entry);
+	break;
+      }
+      if (Equal(Getitem(entry, 0), "end")) {
+	String *rest = NewStringWithSize(start, (int) (tag - start));
+	String *digest = cache_digest(rest);
+	complete = Len(entry) == 2 && Equal(digest, Getitem(entry, 1));
+	Delete(digest);
+	Delete(rest);
+	Delete(entry);
+	break;
+      }
+      Append(entries, entry);
+      Delete(entry);
+    }
+  }
+  Delete(data);
+  if (!complete) {
+    Delete(entries);
+    return 0;
+  }
+  return entries;
+}
+
+/* Whether a file read by an include is as it was when the include was saved */
+static int cache_file_unchanged(String *file, String *digest) {
+  FILE *f = fopen(Char(file), "r");
+  String *s;
+  String *d;
+  int unchanged;
+  if (!f)
+    return 0;
+  s = Swig_read_file(f);
+  fclose(f);
+  Replace(s, "\015", "", DOH_REPLACE_ANY);
+  d = cache_digest(s);
+  unchanged = Equal(d, digest);
+  Delete(d);
+  Delete(s);
+  return unchanged;
+}
+
+/* Loads an include from the cache, returning its output or 0 when it cannot be used */
+static String *cache_load(String *cachefile) {
+  List *entries = cache_read(cachefile);
+  String *output = 0;
+  Hash *symbols = Getattr(cpp, kpp_symbols);
+  Iterator ei;
+
+  if (!entries)
+    return 0;
+  for (ei = First(entries); ei.item; ei = Next(ei)) {
+    String *tag = Getitem(ei.item, 0);
+    if (Equal(tag, "file") && !cache_file_unchanged(Getitem(ei.item, 1), Getitem(ei.item, 2))) {
+      Delete(entries);
+      return 0;
+    }
+  }
+
+  /* Replay what preprocessing the include did */
+  for (ei = First(entries); ei.item; ei = Next(ei)) {
+    String *tag = Getitem(ei.item, 0);
+    if (Equal(tag, "define")) {
+      Hash *macro = NewHash();
+      String *flags = Getitem(ei.item, 3);
+      Setattr(macro, kpp_name, Getitem(ei.item, 1));
+      if (Strchr(flags, 'a')) {
+	List *args = Len(Getitem(ei.item, 4)) ? Split(Getitem(ei.item, 4), ',', -1) : NewList();
+	Setattr(macro, kpp_args, args);
+	Delete(args);
+      }
+      if (Strchr(flags, 'v'))
+	Setattr(macro, kpp_varargs, "1");
+      if (Strchr(flags, 's'))
+	Setattr(macro, kpp_swigmacro, "1");
+      Setattr(macro, kpp_value, Getitem(ei.item, 2));
+      Setfile(macro, Getitem(ei.item, 5));
+      Setline(macro, atoi(Char(Getitem(ei.item, 6))));
+      Setattr(symbols, Getitem(ei.item, 1), macro);
+      Delete(macro);
+    } else if (Equal(tag, "undef")) {
+      Delattr(symbols, Getitem(ei.item, 1));
+    } else if (Equal(tag, "file")) {
+      String *file = Copy(Getitem(ei.item, 1));
+      Setattr(included_files, file, file);
+      if (!dependencies) {
+	dependencies = NewList();
+      }
+      Append(dependencies, file);
+      Delete(file);
+    } else if (Equal(tag, "nowarn")) {
+      Swig_warnfilter(Getitem(ei.item, 1), 1);
+    } else if (Equal(tag, "cpperraswarn")) {
+      error_as_warning = atoi(Char(Getitem(ei.item, 1)));
+    } else if (Equal(tag, "output")) {
+      output = Copy(Getitem(ei.item, 1));
+    }
+  }
+  Delete(entries);
+  return output;
+}
+
+/* -----------------------------------------------------------------------------
+ * include_cached()
+ *
+ * Preprocesses the contents s of an included file like include_parse(), using
+ * the precompiled include cache if there is one.  Only the outermost includes
+ * are cached, and not the main input file itself (cacheable = 0), as it
+ * would always be out of date.
+ * ----------------------------------------------------------------------------- */
+
+static String *include_cached(String *s, int cacheable) {
+  String *cachefile;
+  String *ns;
+  int warnings;
+  int errors;
+
+  if (!cache_dir || cache_journal || !cacheable)
+    return include_parse(s);
+
+  cachefile = cache_key(s);
+  ns = cache_load(cachefile);
+  if (ns) {
+    Delete(cachefile);
+    return ns;
+  }
+
+  warnings = Swig_warn_issued();
+  errors = Swig_error_count();
+  cache_journal = NewList();
+  cache_usable = 1;
+  ns = include_parse(s);
+  if (cache_usable && warnings == Swig_warn_issued() && errors == Swig_error_count())
+    cache_save(cachefile, ns);
+  Delete(cache_journal);
+  cache_journal = 0;
+  Delete(cachefile);
+  return ns;
+}
+
 /*
   push/pop_imported(): helper functions for defining and undefining
   SWIGIMPORTED (when %importing a file).
@@ -1378,6 +2268,9 @@ String *Preprocessor_parse(String *s) {
   int start_level = 0;
   int cpp_lines = 0;
   int cond_lines[256];
+  int guard_state = 0;		/* Include guard: 0 not found yet, 1 inside, 2 found, -1 none */
+  String *guard = 0;
+  int pragma_once = 0;
 
   /* Blow away all carriage returns */
   Replace(s, "\015", "", DOH_REPLACE_ANY);
@@ -1412,6 +2305,8 @@ String *Preprocessor_parse(String *s) {
       }
       break;
     case 1:			/* Non-preprocessor directive */
+      if (level == 0 && !isspace(c) && c != '/')
+	guard_state = -1;	/* Not an include guard, there is code outside it */
       /* Look for SWIG directives */
       if (c == '%') {
 	state = 100;
@@ -1441,8 +2336,11 @@ String *Preprocessor_parse(String *s) {
 	state = 31;
       else if (c == '*')
 	state = 32;
-      else
+      else {
+	if (level == 0)
+	  guard_state = -1;
 	state = 1;
+      }
       break;
     case 31:
       Putc(c, chunk);
@@ -1464,6 +2362,8 @@ String *Preprocessor_parse(String *s) {
 
     case 40:			/* Start of a C preprocessor directive */
       if (c == '\n') {
+	if (level == 0)
+	  guard_state = -1;
 	Putc('\n', chunk);
 	state = 0;
       } else if (isspace(c)) {
@@ -1583,6 +2483,20 @@ String *Preprocessor_parse(String *s) {
     case 50:
       /* Check for various preprocessor directives */
       Chop(value);
+      if (level == 0) {
+	if (guard_state == 0 && Equal(id, kpp_ifndef) && Len(value) > 0) {
+	  guard_state = 1;
+	  guard = Copy(value);
+	} else {
+	  guard_state = -1;
+	}
+      } else if (guard_state == 1) {
+	/* Not an include guard if there is an #else.  Also rule out the directives
+	   that have an effect or give a warning even when skipped */
+	if (((Equal(id, kpp_else) || Equal(id, kpp_elif)) && (level == 1 || Len(value) != 0)) ||
+	    (Equal(id, kpp_endif) && level == 1 && Len(value) != 0) || Equal(id, kpp_pragma))
+	  guard_state = -1;
+      }
       if (Equal(id, kpp_define)) {
 	if (allow) {
 	  DOH *m, *v, *v1;
@@ -1779,7 +2693,9 @@ String *Preprocessor_parse(String *s) {
 	      Delslice(dirname, len - 1, len); /* Kill trailing directory delimiter */
 	      Swig_push_directory(dirname);
 	    }
-	    s2 = Preprocessor_parse(s1);
+	    Swig_profile_begin("include", Swig_last_file());
+	    s2 = include_cached(s1, 1);
+	    Swig_profile_end();
 	    addline(ns, s2, allow);
 	    Append(ns, "%endoffile");
 	    if (dirname) {
@@ -1804,14 +2720,21 @@ String *Preprocessor_parse(String *s) {
 	      String *val = NewString(c + 7);
 	      String *nowarn = Preprocessor_replace(val);
 	      Swig_warnfilter(nowarn, 1);
+	      cache_note("nowarn", nowarn, NIL);
 	      Delete(nowarn);
 	      Delete(val);
 	    } else if (strncmp(c, "cpperraswarn=", 13) == 0) {
+	      String *val;
 	      error_as_warning = atoi(c + 13);
+	      val = NewStringf("%d", error_as_warning);
+	      cache_note("cpperraswarn", val, NIL);
+	      Delete(val);
 	    } else {
               Swig_error(Getfile(s), Getline(id), "Unknown SWIG pragma: %s\n", c);
             }
 	  }
+	} else if (allow && Equal(value, "once")) {
+	  pragma_once = 1;
 	}
       } else if (Equal(id, kpp_level)) {
 	Swig_error(Getfile(s), Getline(id), "cpp debug: level = %d, startlevel = %d\n", level, start_level);
@@ -1825,6 +2748,8 @@ String *Preprocessor_parse(String *s) {
 	if (allow)
 	  Swig_error(Getfile(s), Getline(id), "Unknown SWIG preprocessor directive: %s (if this is a block of target language code, delimit it with %%{ and %%})\n", id);
       }
+      if (guard_state == 1 && level == 0)
+	guard_state = 2;
       for (i = 0; i < cpp_lines; i++)
 	Putc('\n', ns);
       state = 0;
@@ -1933,7 +2858,9 @@ String *Preprocessor_parse(String *s) {
 		Delslice(dirname, len - 1, len); /* Kill trailing directory delimiter */
 		Swig_push_directory(dirname);
 	      }
-	      s2 = Preprocessor_parse(s1);
+	      Swig_profile_begin("include", Swig_last_file());
+	      s2 = include_cached(s1, !(opt && Strstr(opt, "maininput=")));
+	      Swig_profile_end();
 	      if (dirname) {
 		Swig_pop_directory();
 	      }
@@ -2087,5 +3014,15 @@ String *Preprocessor_parse(String *s) {
   Delete(comment);
   Delete(chunk);
 
+  /* Let include_parse() know about any include guard */
+  Delete(parsed_guard);
+  parsed_guard = 0;
+  if (guard_state == 2) {
+    parsed_guard = guard;
+  } else {
+    Delete(guard);
+  }
+  parsed_once = pragma_once;
+
   return ns;
 }
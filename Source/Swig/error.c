@@ -44,6 +44,7 @@ static int silence = 0;		/* Silent operation */
 static String *filter = 0;	/* Warning filter */
 static int warnall = 0;
 static int nwarning = 0;
+static int nissued = 0;		/* Warnings issued, whether shown or filtered out */
 static int nerrors = 0;
 
 static int init_fmt = 0;
@@ -71,6 +72,7 @@ void Swig_warning(int wnum, const_String_or_char_ptr filename, int line, const c
     return;
   if (!init_fmt)
     Swig_error_msg_format(DEFAULT_ERROR_MSG_FORMAT);
+  nissued++;
 
   va_start(ap, fmt);
 
@@ -239,6 +241,17 @@ int Swig_warn_count(void) {
   return nwarning;
 }
 
+/* -----------------------------------------------------------------------------
+ * Swig_warn_issued()
+ *
+ * Return the number of warnings issued, including those not shown because of
+ * the warning filter
+ * ----------------------------------------------------------------------------- */
+
+int Swig_warn_issued(void) {
+  return nissued;
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_error_msg_format()
  *
@@ -20,6 +20,16 @@ static String *lastpath = 0;	        /* Last file that was included */
 static List   *pdirectories = 0;        /* List of pushed directories  */
 static int     dopush = 1;		/* Whether to push directories */
 static int file_debug = 0;
+static Hash   *missing_files = 0;	/* Files in the include path found not to exist */
+static Hash   *file_contents = 0;	/* Contents of the files read by Swig_include() */
+static Hash   *included_files = 0;	/* Full pathnames of the files found by Swig_include() */
+static String *search_path_key = 0;	/* Current search path, as used in the keys of included_files */
+
+/* The search path changed, the files already found may now be found elsewhere */
+static void search_path_changed(void) {
+  Delete(search_path_key);
+  search_path_key = 0;
+}
 
 /* This functions determine whether to push/pop dirs in the preprocessor */
 void Swig_set_push_dir(int push) {
@@ -45,6 +55,7 @@ List *Swig_add_directory(const_String_or_char_ptr dirname) {
     adirname = NewString(dirname);
     Append(directories,adirname);
     Delete(adirname);
+    search_path_changed();
   }
   return directories;
 }
@@ -67,6 +78,7 @@ void Swig_push_directory(const_String_or_char_ptr dirname) {
   assert(pdirname);
   Insert(pdirectories,0,pdirname);
   Delete(pdirname);
+  search_path_changed();
 }
 
 /* -----------------------------------------------------------------------------
@@ -82,6 +94,7 @@ void Swig_pop_directory(void) {
   if (!pdirectories)
     return;
   Delitem(pdirectories, 0);
+  search_path_changed();
 }
 
 /* -----------------------------------------------------------------------------
@@ -151,6 +164,29 @@ List *Swig_search_path() {
 
 
 
+/* -----------------------------------------------------------------------------
+ * open_include_file()
+ *
+ * fopen() a file found while searching the include path.  The same files tend
+ * to be searched for over and over again, so the names of those that do not
+ * exist are remembered and not tried again.
+ * ----------------------------------------------------------------------------- */
+
+static FILE *open_include_file(String *filename) {
+  FILE *f;
+  if (missing_files && Getattr(missing_files, filename))
+    return 0;
+  f = fopen(Char(filename), "r");
+  if (!f) {
+    String *key = Copy(filename);
+    if (!missing_files)
+      missing_files = NewHash();
+    Setattr(missing_files, key, "1");
+    Delete(key);
+  }
+  return f;
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_open()
  *
@@ -176,14 +212,14 @@ static FILE *Swig_open_file(const_String_or_char_ptr name, int sysfile, int use_
   if (file_debug) {
     Printf(stdout, "  Open: %s\n", filename);
   }
-  f = fopen(Char(filename), "r");
+  f = use_include_path ? open_include_file(filename) : fopen(Char(filename), "r");
   if (!f && use_include_path) {
     spath = Swig_search_path_any(sysfile);
     ilen = Len(spath);
     for (i = 0; i < ilen; i++) {
       Clear(filename);
       Printf(filename, "%s%s", Getitem(spath, i), cname);
-      f = fopen(Char(filename), "r");
+      f = open_include_file(filename);
       if (f)
 	break;
     }
@@ -243,22 +279,75 @@ String *Swig_read_file(FILE *f) {
   return str;
 }
 
+/* -----------------------------------------------------------------------------
+ * included_file_key()
+ *
+ * Key of a file in included_files.  The file found for a name depends on the
+ * directories in the search path at the time and on whether it is a system
+ * include, as well as on the name.
+ * ----------------------------------------------------------------------------- */
+
+static String *included_file_key(const_String_or_char_ptr name, int sysfile) {
+  int i, ilen;
+  if (!search_path_key) {
+    search_path_key = NewStringEmpty();
+    ilen = pdirectories ? Len(pdirectories) : 0;
+    for (i = 0; i < ilen; i++)
+      Printf(search_path_key, "%s\n", Getitem(pdirectories, i));
+    Append(search_path_key, "\n");
+    ilen = directories ? Len(directories) : 0;
+    for (i = 0; i < ilen; i++)
+      Printf(search_path_key, "%s\n", Getitem(directories, i));
+  }
+  return NewStringf("%d%s%s", sysfile, search_path_key, name);
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_include()
  *
- * Opens a file and returns it as a string.
+ * Opens a file and returns it as a string.  The contents of the files are
+ * cached, so a file is only read once however many times it is included.  The
+ * file found for a name is remembered too, so that the search path is not
+ * searched again for it while it is unchanged.
  * ----------------------------------------------------------------------------- */
 
 static String *Swig_include_any(const_String_or_char_ptr name, int sysfile) {
   FILE *f;
   String *str;
   String *file;
+  String *key = included_file_key(name, sysfile);
+  String *path = included_files ? Getattr(included_files, key) : 0;
 
-  f = Swig_open_file(name, sysfile, 1);
-  if (!f)
-    return 0;
-  str = Swig_read_file(f);
-  fclose(f);
+  if (path) {
+    Delete(lastpath);
+    lastpath = Copy(path);
+    str = Copy(Getattr(file_contents, path));
+  } else {
+    String *contents;
+    f = Swig_open_file(name, sysfile, 1);
+    if (!f) {
+      Delete(key);
+      return 0;
+    }
+    if (!file_contents)
+      file_contents = NewHash();
+    if (!included_files)
+      included_files = NewHash();
+    path = Copy(Swig_last_file());
+    contents = Getattr(file_contents, path);
+    if (contents) {
+      str = Copy(contents);
+    } else {
+      contents = Swig_read_file(f);
+      Setattr(file_contents, path, contents);
+      str = Copy(contents);
+      Delete(contents);
+    }
+    fclose(f);
+    Setattr(included_files, key, path);
+    Delete(path);
+  }
+  Delete(key);
   Seek(str, 0, SEEK_SET);
   file = Copy(Swig_last_file());
   Setfile(str, file);
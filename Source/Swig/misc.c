@@ -1314,6 +1314,65 @@ void Swig_offset_string(String *s, int number) {
 #ifdef HAVE_PCRE
 #include <pcre.h>
 
+/* -----------------------------------------------------------------------------
+ * Swig_regex_exec()
+ *
+ * Matches subject against the PCRE regex pattern, returning the pcre_exec()
+ * result. Each pattern is compiled, and studied (JIT compiled if supported), the
+ * first time it is used and then kept, as the same %rename and %namewarn regexes
+ * are matched against every declaration. If the pattern does not compile, *err
+ * and *errpos are set and PCRE_ERROR_NOMATCH is returned, otherwise *err is 0.
+ * ----------------------------------------------------------------------------- */
+
+typedef struct {
+  pcre *code;
+  pcre_extra *extra;
+} RegexCompiled;
+
+static Hash *regex_cache = 0;
+
+static void regex_compiled_delete(void *ptr) {
+  RegexCompiled *re = (RegexCompiled *) ptr;
+#ifdef PCRE_STUDY_JIT_COMPILE
+  pcre_free_study(re->extra);
+#else
+  pcre_free(re->extra);
+#endif
+  pcre_free(re->code);
+  free(re);
+}
+
+int Swig_regex_exec(String *pattern, const char *subject, int len, int *captures, int ncaptures, const char **err, int *errpos) {
+  RegexCompiled *re;
+  DOH *compiled;
+
+  if (!regex_cache)
+    regex_cache = NewHash();
+  compiled = Getattr(regex_cache, pattern);
+  if (compiled) {
+    re = (RegexCompiled *) Data(compiled);
+  } else {
+    const char *study_err = 0;
+    pcre *code = pcre_compile(Char(pattern), 0, err, errpos, NULL);
+    if (!code)
+      return PCRE_ERROR_NOMATCH;
+    re = (RegexCompiled *) malloc(sizeof(RegexCompiled));
+    re->code = code;
+#ifdef PCRE_STUDY_JIT_COMPILE
+    re->extra = pcre_study(code, PCRE_STUDY_JIT_COMPILE, &study_err);
+#else
+    re->extra = pcre_study(code, 0, &study_err);
+#endif
+    /* A failed study only loses the optimizations */
+    (void)study_err;
+    compiled = NewVoid(re, regex_compiled_delete);
+    Setattr(regex_cache, pattern, compiled);
+    Delete(compiled);
+  }
+  *err = 0;
+  return pcre_exec(re->code, re->extra, subject, len, 0, 0, captures, ncaptures);
+}
+
 static int split_regex_pattern_subst(String *s, String **pattern, String **subst, const char **input)
 {
   const char *pats, *pate;
@@ -1446,10 +1505,7 @@ String *replace_captures(int num_captures, const char *input, String *subst, int
  *   Printf(stderr,"gsl%(regex:/GSL_(.*)_/\\1/)s", "GSL_Hello_") -> gslHello
  * ----------------------------------------------------------------------------- */
 String *Swig_string_regex(String *s) {
-  const int pcre_options = 0;
-
   String *res = 0;
-  pcre *compiled_pat = 0;
   const char *pcre_error, *input;
   int pcre_errorpos;
   String *pattern = 0, *subst = 0;
@@ -1458,14 +1514,12 @@ String *Swig_string_regex(String *s) {
   if (split_regex_pattern_subst(s, &pattern, &subst, &input)) {
     int rc;
 
-    compiled_pat = pcre_compile(
-          Char(pattern), pcre_options, &pcre_error, &pcre_errorpos, NULL);
-    if (!compiled_pat) {
+    rc = Swig_regex_exec(pattern, input, (int)strlen(input), captures, 30, &pcre_error, &pcre_errorpos);
+    if (pcre_error) {
       Swig_error("SWIG", Getline(s), "PCRE compilation failed: '%s' in '%s':%i.\n",
           pcre_error, Char(pattern), pcre_errorpos);
       SWIG_exit(EXIT_FAILURE);
     }
-    rc = pcre_exec(compiled_pat, NULL, input, (int)strlen(input), 0, 0, captures, 30);
     if (rc >= 0) {
       res = replace_captures(rc, input, subst, captures, pattern, s);
     } else if (rc != PCRE_ERROR_NOMATCH) {
@@ -1477,7 +1531,6 @@ String *Swig_string_regex(String *s) {
 
   DohDelete(pattern);
   DohDelete(subst);
-  pcre_free(compiled_pat);
   return res ? res : NewStringEmpty();
 }
 
@@ -1487,6 +1540,17 @@ String *Swig_pcre_version(void) {
 
 #else
 
+int Swig_regex_exec(String *pattern, const char *subject, int len, int *captures, int ncaptures, const char **err, int *errpos) {
+  (void)pattern;
+  (void)subject;
+  (void)len;
+  (void)captures;
+  (void)ncaptures;
+  *err = "PCRE regex support not enabled in this SWIG build";
+  *errpos = 0;
+  return -1;
+}
+
 String *Swig_string_regex(String *s) {
   Swig_error("SWIG", Getline(s), "PCRE regex support not enabled in this SWIG build.\n");
   SWIG_exit(EXIT_FAILURE);
@@ -1037,6 +1037,209 @@ static void name_object_attach_keys(const char *keys[], Hash *nameobj) {
   }
 }
 
+/* -----------------------------------------------------------------------------
+ * The nameobj list index
+ *
+ * The nameobjs that cannot go in the name hash are kept in a list, which used to
+ * be searched in full for every declaration. They are also indexed by the exact
+ * name they match, else by the node type they match, so that only the plausible
+ * ones are tried. The literal prefix and suffix of a regex applied to the name,
+ * if any, are also recorded to avoid running it when it cannot match. Each index
+ * bucket keeps its nameobjs in the order they were added, with a sequence number
+ * to merge the buckets back into the list order (last added first).
+ * ----------------------------------------------------------------------------- */
+
+typedef struct {
+  Hash *nameobj;
+  int seq;
+  String *prefix;		/* literal prefix the name must have, or 0 */
+  String *suffix;		/* literal suffix the name must have, or 0 */
+} NameObjEntry;
+
+static int nameobj_seq = 0;
+
+static void nameobj_entry_delete(void *ptr) {
+  NameObjEntry *entry = (NameObjEntry *) ptr;
+  Delete(entry->prefix);
+  Delete(entry->suffix);
+  free(entry);
+}
+
+/* Characters with a special meaning in a regex, outside of a character class */
+static int regex_special(char c) {
+  return c && strchr("\\^$.[]|()?*+{}", c) != 0;
+}
+
+/* Check that the literal characters at the start and end of a regex are matched
+   as such, they are not if there are options, verbs, \Q quoting or alternatives */
+static int regex_literals_usable(const char *p) {
+  int depth = 0;
+  if (strstr(p, "(?") || strstr(p, "(*") || strstr(p, "\\Q") || strstr(p, "[:"))
+    return 0;
+  for (; *p; ++p) {
+    if (*p == '\\') {
+      if (!*++p)
+	return 0;
+    } else if (*p == '[') {
+      ++p;
+      if (*p == '^')
+	++p;
+      if (*p == ']')
+	++p;
+      while (*p && *p != ']') {
+	if (*p == '\\' && p[1])
+	  ++p;
+	++p;
+      }
+      if (!*p)
+	return 0;
+    } else if (*p == '(') {
+      ++depth;
+    } else if (*p == ')') {
+      --depth;
+    } else if (*p == '|' && depth <= 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* The literal prefix of an anchored regex, such as "foo" for "^foo_(.*)" */
+static String *regex_literal_prefix(const char *p) {
+  const char *b, *e;
+  if (*p != '^')
+    return 0;
+  b = e = p + 1;
+  while (*e && !regex_special(*e))
+    ++e;
+  /* The last character may be optional */
+  if (e > b && (*e == '?' || *e == '*' || *e == '{'))
+    --e;
+  return e > b ? NewStringWithSize(b, (int)(e - b)) : 0;
+}
+
+/* The literal suffix of an anchored regex, such as "_t" for "(.*)_t$" */
+static String *regex_literal_suffix(const char *p) {
+  const char *b;
+  const char *e = p + strlen(p);
+  int escapes = 0;
+  if (e == p || e[-1] != '$')
+    return 0;
+  for (b = --e; b > p && b[-1] == '\\'; --b)
+    ++escapes;
+  if (escapes % 2)
+    return 0;
+  for (b = e; b > p && !regex_special(b[-1]); --b) {
+  }
+  /* The first character may be an escape sequence */
+  if (b > p && b[-1] == '\\' && b < e)
+    ++b;
+  return e > b ? NewStringWithSize(b, (int)(e - b)) : 0;
+}
+
+/* The regex of a "%(regex:/pattern/subst/)s" name format, that applies it to the whole name */
+static String *name_format_regex(String *fmt) {
+  const char *b = Char(fmt);
+  const char *e;
+  int level = 1;
+  if (!b || strncmp(b, "%(regex:/", 9) != 0)
+    return 0;
+  b += 9;
+  for (e = b; *e && level; ++e) {
+    if (*e == '(')
+      ++level;
+    else if (*e == ')')
+      --level;
+  }
+  if (level || strcmp(e, "s") != 0)
+    return 0;
+  e = strchr(b, '/');
+  return e ? NewStringWithSize(b, (int)(e - b)) : 0;
+}
+
+static Hash *nameobj_index(List *name_list) {
+  Hash *index = Getmeta(name_list, "index");
+  if (!index) {
+    Hash *names = NewHash();
+    Hash *types = NewHash();
+    List *others = NewList();
+    index = NewHash();
+    Setattr(index, "name", names);
+    Setattr(index, "nodeType", types);
+    Setattr(index, "other", others);
+    Setmeta(name_list, "index", index);
+    Delete(names);
+    Delete(types);
+    Delete(others);
+    Delete(index);
+  }
+  return index;
+}
+
+static void nameobj_index_add(List *name_list, Hash *nameobj) {
+  Hash *index = nameobj_index(name_list);
+  NameObjEntry *entry = (NameObjEntry *) malloc(sizeof(NameObjEntry));
+  List *bucket = Getattr(index, "other");
+  DOH *ventry;
+  entry->nameobj = nameobj;
+  entry->seq = ++nameobj_seq;
+  entry->prefix = 0;
+  entry->suffix = 0;
+
+#if !defined(SWIG_USE_SIMPLE_MATCHOR)
+  {
+    /* Only the rules matching the plain name, without a format or its scope, use its literal form */
+    int plain = !Getattr(nameobj, "sourcefmt") && !GetFlag(nameobj, "fullname");
+    String *tname = Getattr(nameobj, "targetname");
+    String *regex = 0;
+    List *matchlist = Getattr(nameobj, "matchlist");
+
+    if (tname) {
+      if (GetFlag(nameobj, "regextarget")) {
+	if (plain)
+	  regex = Copy(tname);
+      } else if (plain) {
+	bucket = Getattr(Getattr(index, "name"), tname);
+	if (!bucket) {
+	  bucket = NewList();
+	  Setattr(Getattr(index, "name"), tname, bucket);
+	  Delete(bucket);
+	}
+      }
+    } else {
+      regex = name_format_regex(Getattr(nameobj, "name"));
+    }
+    if (regex && regex_literals_usable(Char(regex))) {
+      entry->prefix = regex_literal_prefix(Char(regex));
+      entry->suffix = regex_literal_suffix(Char(regex));
+    }
+    Delete(regex);
+
+    if (matchlist && bucket == Getattr(index, "other")) {
+      int i;
+      for (i = 0; i < Len(matchlist); ++i) {
+	Hash *mi = Getitem(matchlist, i);
+	List *attrlist = Getattr(mi, "attrlist");
+	if (!GetFlag(mi, "notmatch") && !GetFlag(mi, "regexmatch") && Len(attrlist) == 1 && Equal(Getitem(attrlist, 0), "nodeType")) {
+	  String *type = Getattr(mi, "value");
+	  bucket = Getattr(Getattr(index, "nodeType"), type);
+	  if (!bucket) {
+	    bucket = NewList();
+	    Setattr(Getattr(index, "nodeType"), type, bucket);
+	    Delete(bucket);
+	  }
+	  break;
+	}
+      }
+    }
+  }
+#endif
+
+  ventry = NewVoid(entry, nameobj_entry_delete);
+  Append(bucket, ventry);
+  Delete(ventry);
+}
+
 static void name_nameobj_add(Hash *name_hash, List *name_list, String *prefix, String *name, SwigType *decl, Hash *nameobj) {
   String *nname = 0;
   if (name && Len(name)) {
@@ -1058,6 +1261,7 @@ static void name_nameobj_add(Hash *name_hash, List *name_list, String *prefix, S
     /* put the new nameobj at the beginning of the list, such that the
        last inserted rule take precedence */
     Insert(name_list, 0, nameobj);
+    nameobj_index_add(name_list, nameobj);
   } else {
     /* here we add an old 'hash' nameobj, simple and fast */
     Swig_name_object_set(name_hash, nname, decl, nameobj);
@@ -1095,22 +1299,18 @@ static DOH *get_lattr(Node *n, List *lattr) {
 #include <pcre.h>
 
 static int name_regexmatch_value(Node *n, String *pattern, String *s) {
-  pcre *compiled_pat;
   const char *err;
   int errpos;
   int rc;
 
-  compiled_pat = pcre_compile(Char(pattern), 0, &err, &errpos, NULL);
-  if (!compiled_pat) {
+  rc = Swig_regex_exec(pattern, Char(s), Len(s), NULL, 0, &err, &errpos);
+  if (err) {
     Swig_error("SWIG", Getline(n),
                "Invalid regex \"%s\": compilation failed at %d: %s\n",
                Char(pattern), errpos, err);
     SWIG_exit(EXIT_FAILURE);
   }
 
-  rc = pcre_exec(compiled_pat, NULL, Char(s), Len(s), 0, 0, NULL, 0);
-  pcre_free(compiled_pat);
-
   if (rc == PCRE_ERROR_NOMATCH)
     return 0;
 
@@ -1163,9 +1363,32 @@ static int name_match_value(String *mvalue, String *value) {
 #endif
 }
 
+/* Pre-interned keys for the attributes looked up for every rule and every node */
+static String *key_matchlist = 0;
+static String *key_attrlist = 0;
+static String *key_notmatch = 0;
+static String *key_regexmatch = 0;
+static String *key_value = 0;
+static String *key_decl = 0;
+static String *key_targetname = 0;
+
+static void name_keys_init(void) {
+  if (key_matchlist)
+    return;
+  key_matchlist = InternKey("matchlist");
+  key_attrlist = InternKey("attrlist");
+  key_notmatch = InternKey("notmatch");
+  key_regexmatch = InternKey("regexmatch");
+  key_value = InternKey("value");
+  key_decl = InternKey("decl");
+  key_targetname = InternKey("targetname");
+}
+
 static int name_match_nameobj(Hash *rn, Node *n) {
   int match = 1;
-  List *matchlist = Getattr(rn, "matchlist");
+  List *matchlist;
+  name_keys_init();
+  matchlist = Getattr(rn, key_matchlist);
 #ifdef SWIG_DEBUG
   Printf(stdout, "name_match_nameobj: %s\n", Getattr(n, "name"));
 #endif
@@ -1174,13 +1397,13 @@ static int name_match_nameobj(Hash *rn, Node *n) {
     int i;
     for (i = 0; match && (i < ilen); ++i) {
       Node *mi = Getitem(matchlist, i);
-      List *lattr = Getattr(mi, "attrlist");
+      List *lattr = Getattr(mi, key_attrlist);
       String *nval = get_lattr(n, lattr);
-      int notmatch = GetFlag(mi, "notmatch");
-      int regexmatch = GetFlag(mi, "regexmatch");
+      int notmatch = GetFlag(mi, key_notmatch);
+      int regexmatch = GetFlag(mi, key_regexmatch);
       match = 0;
       if (nval) {
-	String *kwval = Getattr(mi, "value");
+	String *kwval = Getattr(mi, key_value);
 	match = regexmatch ? name_regexmatch_value(n, kwval, nval)
 	    : name_match_value(kwval, nval);
 #ifdef SWIG_DEBUG
@@ -1204,60 +1427,96 @@ static int name_match_nameobj(Hash *rn, Node *n) {
  * 
  * ----------------------------------------------------------------------------- */
 
-static Hash *name_nameobj_lget(List *namelist, Node *n, String *prefix, String *name, String *decl) {
-  Hash *res = 0;
-  if (namelist) {
-    int len = Len(namelist);
-    int i;
-    int match = 0;
-    for (i = 0; !match && (i < len); i++) {
-      Hash *rn = Getitem(namelist, i);
-      String *rdecl = Getattr(rn, "decl");
-      if (rdecl && (!decl || !Equal(rdecl, decl))) {
-	continue;
-      } else if (name_match_nameobj(rn, n)) {
-	String *tname = Getattr(rn, "targetname");
-	if (tname) {
-	  String *sfmt = Getattr(rn, "sourcefmt");
-	  String *sname = 0;
-	  int fullname = GetFlag(rn, "fullname");
-	  int regextarget = GetFlag(rn, "regextarget");
-	  if (sfmt) {
-	    if (fullname && prefix) {
-	      String *pname = NewStringf("%s::%s", prefix, name);
-	      sname = NewStringf(sfmt, pname);
-	      Delete(pname);
-	    } else {
-	      sname = NewStringf(sfmt, name);
-	    }
-	  } else {
-	    if (fullname && prefix) {
-	      sname = NewStringf("%s::%s", prefix, name);
-	    } else {
-	      sname = name;
-	      DohIncref(name);
-	    }
-	  }
-	  match = regextarget ? name_regexmatch_value(n, tname, sname)
-	    : name_match_value(tname, sname);
-	  Delete(sname);
+static int name_nameobj_lmatch(Hash *rn, Node *n, String *prefix, String *name) {
+  int match = 0;
+  if (name_match_nameobj(rn, n)) {
+    String *tname = Getattr(rn, key_targetname);
+    if (tname) {
+      String *sfmt = Getattr(rn, "sourcefmt");
+      String *sname = 0;
+      int fullname = GetFlag(rn, "fullname");
+      int regextarget = GetFlag(rn, "regextarget");
+      if (sfmt) {
+	if (fullname && prefix) {
+	  String *pname = NewStringf("%s::%s", prefix, name);
+	  sname = NewStringf(sfmt, pname);
+	  Delete(pname);
 	} else {
-	  /* Applying the renaming rule may fail if it contains a %(regex)s expression that doesn't match the given name. */
-	  String *sname = NewStringf(Getattr(rn, "name"), name);
-	  if (sname) {
-	    if (Len(sname))
-	      match = 1;
-	    Delete(sname);
-	  }
+	  sname = NewStringf(sfmt, name);
+	}
+      } else {
+	if (fullname && prefix) {
+	  sname = NewStringf("%s::%s", prefix, name);
+	} else {
+	  sname = name;
+	  DohIncref(name);
 	}
       }
-      if (match) {
-	res = rn;
-	break;
+      match = regextarget ? name_regexmatch_value(n, tname, sname)
+	: name_match_value(tname, sname);
+      Delete(sname);
+    } else {
+      /* Applying the renaming rule may fail if it contains a %(regex)s expression that doesn't match the given name. */
+      String *sname = NewStringf(Getattr(rn, "name"), name);
+      if (sname) {
+	if (Len(sname))
+	  match = 1;
+	Delete(sname);
       }
     }
   }
-  return res;
+  return match;
+}
+
+/* Quick checks of the decl and name before trying a nameobj of the list */
+static int name_nameobj_plausible(NameObjEntry *entry, String *name, String *decl) {
+  String *rdecl = Getattr(entry->nameobj, key_decl);
+  if (rdecl && (!decl || !Equal(rdecl, decl)))
+    return 0;
+  if (name && entry->prefix && strncmp(Char(name), Char(entry->prefix), Len(entry->prefix)) != 0)
+    return 0;
+  if (name && entry->suffix) {
+    int len = Len(name);
+    int slen = Len(entry->suffix);
+    if (len < slen || strcmp(Char(name) + len - slen, Char(entry->suffix)) != 0)
+      return 0;
+  }
+  return 1;
+}
+
+static Hash *name_nameobj_lget(List *namelist, Node *n, String *prefix, String *name, String *decl) {
+  Hash *index = namelist ? Getmeta(namelist, "index") : 0;
+  List *buckets[3];
+  int pos[3];
+  int i;
+  if (!index)
+    return 0;
+  name_keys_init();
+  buckets[0] = name ? Getattr(Getattr(index, "name"), name) : 0;
+  buckets[1] = n && nodeType(n) ? Getattr(Getattr(index, "nodeType"), nodeType(n)) : 0;
+  buckets[2] = Getattr(index, "other");
+  for (i = 0; i < 3; ++i)
+    pos[i] = buckets[i] ? Len(buckets[i]) - 1 : -1;
+
+  /* Try the nameobjs of the buckets from the last added, as in the list */
+  for (;;) {
+    NameObjEntry *entry = 0;
+    int next = 0;
+    for (i = 0; i < 3; ++i) {
+      if (pos[i] >= 0) {
+	NameObjEntry *e = (NameObjEntry *) Data(Getitem(buckets[i], pos[i]));
+	if (!entry || e->seq > entry->seq) {
+	  entry = e;
+	  next = i;
+	}
+      }
+    }
+    if (!entry)
+      return 0;
+    pos[next]--;
+    if (name_nameobj_plausible(entry, name, decl) && name_nameobj_lmatch(entry->nameobj, n, prefix, name))
+      return entry->nameobj;
+  }
 }
 
 /* -----------------------------------------------------------------------------
@@ -0,0 +1,255 @@
+/* -----------------------------------------------------------------------------
+ * This file is part of SWIG, which is licensed as a whole under version 3
+ * (or any later version) of the GNU General Public License. Some additional
+ * terms also apply to certain portions of SWIG. The full details of the SWIG
+ * license and copyrights can be found in the LICENSE and COPYRIGHT files
+ * included with the SWIG source code as distributed by the SWIG developers
+ * and at http://www.swig.org/legal.html.
+ *
+ * profile.c
+ *
+ * Support for the -profile option.  Intervals of a run, such as the phases,
+ * the preprocessing of each included file and the processing of each class,
+ * are marked with Swig_profile_begin() and Swig_profile_end().  The wall time
+ * and the number of DOH allocations of each interval are recorded.
+ * Swig_profile_report() displays the totals per phase, file and class, and
+ * Swig_profile_trace() writes every interval in the Chrome trace event format,
+ * which can be viewed with chrome://tracing or Perfetto.
+ * ----------------------------------------------------------------------------- */
+
+#include "swig.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+typedef struct ProfileEvent {
+  const char *category;		/* "phase", "include", "class", ... */
+  char *name;
+  double start;			/* Microseconds since profiling was enabled */
+  double duration;		/* Microseconds */
+  unsigned long allocs;		/* DOH allocations made during the interval */
+} ProfileEvent;
+
+typedef struct ProfileTotal {
+  const char *category;
+  const char *name;
+  double duration;
+  unsigned long allocs;
+  int count;
+} ProfileTotal;
+
+static int profile_enabled = 0;
+static double profile_origin = 0;
+static ProfileEvent *events = 0;
+static int events_count = 0;
+static int events_max = 0;
+static int *open_events = 0;	/* Stack of the intervals not ended yet */
+static int open_count = 0;
+static int open_max = 0;
+
+/* Categories in the order they are reported */
+static const char *profile_categories[] = { "phase", "include", "class", 0 };
+
+/* Number of the largest totals displayed per category, other than phases */
+#define PROFILE_REPORT_MAX 25
+
+static double profile_now(void) {
+#ifdef _WIN32
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return (double) counter.QuadPart * 1000000.0 / (double) frequency.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return (double) tv.tv_sec * 1000000.0 + (double) tv.tv_usec;
+#endif
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_profile_enable()
+ *
+ * Start recording.  Times are relative to when this is first called.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_profile_enable(void) {
+  if (!profile_enabled) {
+    profile_enabled = 1;
+    profile_origin = profile_now();
+  }
+}
+
+int Swig_profile_enabled(void) {
+  return profile_enabled;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_profile_begin()
+ *
+ * Start an interval.  Intervals nest and each one is ended by a matching
+ * call to Swig_profile_end().
+ * ----------------------------------------------------------------------------- */
+
+void Swig_profile_begin(const char *category, const_String_or_char_ptr name) {
+  ProfileEvent *e;
+  if (!profile_enabled)
+    return;
+  if (events_count == events_max) {
+    events_max = events_max ? events_max * 2 : 1024;
+    events = (ProfileEvent *) realloc(events, events_max * sizeof(ProfileEvent));
+    assert(events);
+  }
+  if (open_count == open_max) {
+    open_max = open_max ? open_max * 2 : 64;
+    open_events = (int *) realloc(open_events, open_max * sizeof(int));
+    assert(open_events);
+  }
+  e = &events[events_count];
+  e->category = category;
+  e->name = Swig_copy_string(name ? Char(name) : "");
+  e->duration = 0;
+  e->allocs = DohMemoryAllocations();
+  open_events[open_count++] = events_count++;
+  e->start = profile_now() - profile_origin;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_profile_end()
+ *
+ * End the most recently started interval.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_profile_end(void) {
+  ProfileEvent *e;
+  if (!profile_enabled)
+    return;
+  assert(open_count > 0);
+  e = &events[open_events[--open_count]];
+  e->duration = profile_now() - profile_origin - e->start;
+  e->allocs = DohMemoryAllocations() - e->allocs;
+}
+
+static int compare_events(const void *a, const void *b) {
+  const ProfileEvent *ea = *(const ProfileEvent *const *) a;
+  const ProfileEvent *eb = *(const ProfileEvent *const *) b;
+  int c = strcmp(ea->category, eb->category);
+  return c ? c : strcmp(ea->name, eb->name);
+}
+
+static int compare_totals(const void *a, const void *b) {
+  const ProfileTotal *ta = (const ProfileTotal *) a;
+  const ProfileTotal *tb = (const ProfileTotal *) b;
+  if (ta->duration != tb->duration)
+    return ta->duration < tb->duration ? 1 : -1;
+  return strcmp(ta->name, tb->name);
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_profile_report()
+ *
+ * Display the time and allocations per phase, included file and class, largest
+ * first.  Intervals with the same name are added up; the figures of a file or
+ * class include those of the files or classes nested within it.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_profile_report(void) {
+  ProfileEvent **sorted;
+  ProfileTotal *totals;
+  int ntotals = 0;
+  int i, c;
+
+  if (!profile_enabled)
+    return;
+
+  sorted = (ProfileEvent **) malloc((events_count + 1) * sizeof(ProfileEvent *));
+  totals = (ProfileTotal *) malloc((events_count + 1) * sizeof(ProfileTotal));
+  assert(sorted && totals);
+  for (i = 0; i < events_count; i++)
+    sorted[i] = &events[i];
+  qsort(sorted, events_count, sizeof(ProfileEvent *), compare_events);
+  for (i = 0; i < events_count; i++) {
+    ProfileEvent *e = sorted[i];
+    if (ntotals == 0 || compare_events(&sorted[i - 1], &sorted[i]) != 0) {
+      totals[ntotals].category = e->category;
+      totals[ntotals].name = e->name;
+      totals[ntotals].duration = 0;
+      totals[ntotals].allocs = 0;
+      totals[ntotals].count = 0;
+      ntotals++;
+    }
+    totals[ntotals - 1].duration += e->duration;
+    totals[ntotals - 1].allocs += e->allocs;
+    totals[ntotals - 1].count++;
+  }
+  qsort(totals, ntotals, sizeof(ProfileTotal), compare_totals);
+
+  printf("Profile (wall time in ms, DOH allocations), total %.1f ms, %lu allocations\n", (profile_now() - profile_origin) / 1000.0, DohMemoryAllocations());
+  for (c = 0; profile_categories[c]; c++) {
+    const char *category = profile_categories[c];
+    int shown = 0;
+    int hidden = 0;
+    printf("\n  %-50s %12s %12s %8s\n", category, "time", "allocs", "count");
+    for (i = 0; i < ntotals; i++) {
+      ProfileTotal *t = &totals[i];
+      if (strcmp(t->category, category) != 0)
+	continue;
+      if (c > 0 && shown == PROFILE_REPORT_MAX) {
+	hidden++;
+	continue;
+      }
+      printf("  %-50s %12.1f %12lu %8d\n", t->name, t->duration / 1000.0, t->allocs, t->count);
+      shown++;
+    }
+    if (hidden)
+      printf("  ... %d more\n", hidden);
+  }
+  fflush(stdout);
+
+  free(totals);
+  free(sorted);
+}
+
+/* Write s as a JSON string */
+static void trace_string(FILE *f, const char *s) {
+  fputc('"', f);
+  for (; *s; s++) {
+    unsigned char ch = (unsigned char) *s;
+    if (ch == '"' || ch == '\\')
+      fprintf(f, "\\%c", ch);
+    else if (ch < 0x20)
+      fprintf(f, "\\u%04x", ch);
+    else
+      fputc(ch, f);
+  }
+  fputc('"', f);
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_profile_trace()
+ *
+ * Write all the intervals to the named file as Chrome trace events.  Returns 0
+ * if the file cannot be written.
+ * ----------------------------------------------------------------------------- */
+
+int Swig_profile_trace(const_String_or_char_ptr filename) {
+  FILE *f;
+  int i;
+
+  if (!profile_enabled)
+    return 1;
+  f = fopen(Char(filename), "w");
+  if (!f)
+    return 0;
+  fprintf(f, "{\"traceEvents\":[");
+  for (i = 0; i < events_count; i++) {
+    ProfileEvent *e = &events[i];
+    fprintf(f, "%s\n{\"name\":", i ? "," : "");
+    trace_string(f, e->name);
+    fprintf(f, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.0f,\"dur\":%.0f,\"pid\":1,\"tid\":1,\"args\":{\"allocs\":%lu}}", e->category, e->start, e->duration, e->allocs);
+  }
+  fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+  return fclose(f) == 0;
+}
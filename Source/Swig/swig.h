@@ -202,6 +202,8 @@ extern "C" {
   extern Typetab *SwigType_pop_scope(void);
   extern Typetab *SwigType_set_scope(Typetab *h);
   extern void SwigType_print_scope(void);
+  extern int SwigType_typesystem_generation(void);
+  extern void SwigType_typedef_cache_debug_stats(void);
   extern SwigType *SwigType_typedef_resolve(const SwigType *t);
   extern SwigType *SwigType_typedef_resolve_all(const SwigType *t);
   extern SwigType *SwigType_typedef_qualified(const SwigType *t);
@@ -213,6 +215,7 @@ extern "C" {
   extern void SwigType_remember_mangleddata(String *mangled, const_String_or_char_ptr clientdata);
   extern void (*SwigType_remember_trace(void (*tf) (const SwigType *, String *, String *))) (const SwigType *, String *, String *);
   extern void SwigType_emit_type_table(File *f_headers, File *f_table);
+  extern void SwigType_type_table_shared(const_String_or_char_ptr name);
   extern int SwigType_type(const SwigType *t);
 
 /* --- Symbol table module --- */
@@ -231,6 +234,7 @@ extern "C" {
   extern Symtab *Swig_symbol_getscope(const_String_or_char_ptr symname);
   extern Symtab *Swig_symbol_global_scope(void);
   extern Symtab *Swig_symbol_current(void);
+  extern int Swig_symbol_generation(void);
   extern Symtab *Swig_symbol_popscope(void);
   extern Node *Swig_symbol_add(const_String_or_char_ptr symname, Node *node);
   extern void Swig_symbol_cadd(const_String_or_char_ptr symname, Node *node);
@@ -335,6 +339,7 @@ extern int        ParmList_is_compactdefargs(ParmList *p);
   extern String *Swig_string_title(String *s);
   extern void Swig_offset_string(String *s, int number);
   extern String *Swig_pcre_version(void);
+  extern int Swig_regex_exec(String *pattern, const char *subject, int len, int *captures, int ncaptures, const char **err, int *errpos);
   extern void Swig_init(void);
 
   extern int Swig_value_wrapper_mode(int mode);
@@ -349,6 +354,7 @@ extern int        ParmList_is_compactdefargs(ParmList *p);
   extern void Swig_warnfilter(const_String_or_char_ptr wlist, int val);
   extern void Swig_warnall(void);
   extern int Swig_warn_count(void);
+  extern int Swig_warn_issued(void);
   extern void Swig_error_msg_format(ErrorMessageFormat format);
   extern void Swig_diagnostic(const_String_or_char_ptr filename, int line, const char *fmt, ...);
   extern String *Swig_stringify_with_location(DOH *object);
@@ -408,6 +414,7 @@ extern int        ParmList_is_compactdefargs(ParmList *p);
   extern void Swig_typemap_replace_embedded_typemap(String *s, Node *file_line_node);
   extern void Swig_typemap_debug(void);
   extern void Swig_typemap_search_debug_set(void);
+  extern void Swig_typemap_search_debug_stats(void);
   extern void Swig_typemap_used_debug_set(void);
   extern void Swig_typemap_register_debug_set(void);
 
@@ -429,6 +436,15 @@ extern int        ParmList_is_compactdefargs(ParmList *p);
   extern void Swig_extend_append_previous(Node *cls, Node *am);
   extern void Swig_extend_unused_check(void);
 
+/* --- Profiling --- */
+
+  extern void Swig_profile_enable(void);
+  extern int Swig_profile_enabled(void);
+  extern void Swig_profile_begin(const char *category, const_String_or_char_ptr name);
+  extern void Swig_profile_end(void);
+  extern void Swig_profile_report(void);
+  extern int Swig_profile_trace(const_String_or_char_ptr filename);
+
 /* hacks defined in C++ ! */
   extern int Swig_director_mode(void);
   extern int Swig_director_protected_mode(void);
@@ -175,6 +175,7 @@ static Hash *symtabs = 0;	/* Hash of all symbol tables by fully-qualified name *
 static Hash *global_scope = 0;	/* Global scope */
 
 static int use_inherit = 1;
+static int symbol_generation = 0;	/* Bumped whenever the C symbol tables change */
 
 /* common attribute keys, to avoid calling find_key all the times */
 
@@ -394,6 +395,7 @@ Symtab *Swig_symbol_newscope(void) {
 
   hsyms = NewHash();
   h = NewHash();
+  symbol_generation++;
 
   set_nodeType(h, "symboltable");
   Setattr(h, "symtab", hsyms);
@@ -470,6 +472,17 @@ Symtab *Swig_symbol_current(void) {
   return current_symtab;
 }
 
+/* -----------------------------------------------------------------------------
+ * Swig_symbol_generation()
+ *
+ * Returns a number that changes whenever a C symbol table or scope is modified,
+ * for use by caches of results that depend on symbol lookups.
+ * ----------------------------------------------------------------------------- */
+
+int Swig_symbol_generation(void) {
+  return symbol_generation;
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_symbol_alias()
  *
@@ -486,6 +499,7 @@ void Swig_symbol_alias(const_String_or_char_ptr aliasname, Symtab *s) {
   }
   if (!Getattr(symtabs, qname)) {
     Setattr(symtabs, qname, s);
+    symbol_generation++;
   }
   Delete(qname);
 }
@@ -519,6 +533,7 @@ void Swig_symbol_inherit(Symtab *s) {
       return;			/* Already inherited */
   }
   Append(inherit, s);
+  symbol_generation++;
 }
 
 /* -----------------------------------------------------------------------------
@@ -549,6 +564,7 @@ void Swig_symbol_cadd(const_String_or_char_ptr name, Node *n) {
   if (!name)
     return;
 
+  symbol_generation++;
   if (SwigType_istemplate(name)) {
     String *cname = NewString(name);
     String *dname = Swig_symbol_template_deftype(cname, 0);
@@ -1398,6 +1414,7 @@ void Swig_symbol_remove(Node *n) {
   Node *symprev;
   Node *symnext;
   Node *fixovername = 0;
+  symbol_generation++;
   symtab = Getattr(n, "sym:symtab");	/* Get symbol table object */
   symtab = Getattr(symtab, "symtab");	/* Get actual hash table of symbols */
   symname = Getattr(n, "sym:name");
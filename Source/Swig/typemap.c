@@ -61,6 +61,29 @@ static void replace_embedded_typemap(String *s, ParmList *parm_sublist, Wrapper
 
 static Hash *typemaps;
 
+/* Pre-interned "code" key, looked up for every candidate typemap during a search */
+static String *key_code = 0;
+
+/* -----------------------------------------------------------------------------
+ * Typemap search cache
+ *
+ * The same typemap searches are repeated many times over, so the results of
+ * typemap_search() are cached.  A search depends on the registered typemaps,
+ * the typedefs in the type system and the symbol tables (for templates), so
+ * the cache is flushed whenever any of these change, as tracked by generation
+ * counters, or when the current symbol table scope differs from the one the
+ * cache was filled in.
+ * ----------------------------------------------------------------------------- */
+
+static Hash *search_cache = 0;
+static int typemaps_generation = 0;	/* Bumped whenever the typemaps change */
+static int search_cache_typemaps_generation = 0;
+static int search_cache_typesystem_generation = 0;
+static int search_cache_symbol_generation = 0;
+static Symtab *search_cache_scope = 0;
+static int search_cache_hits = 0;
+static int search_cache_misses = 0;
+
 /* -----------------------------------------------------------------------------
  * typemap_identifier_fix()
  *
@@ -153,6 +176,17 @@ static void set_typemap(const SwigType *type, Hash **tmhash) {
 
 void Swig_typemap_init() {
   typemaps = NewHash();
+  key_code = InternKey("code");
+}
+
+/* -----------------------------------------------------------------------------
+ * typemaps_changed()
+ *
+ * Must be called whenever the typemaps are modified to invalidate cached searches
+ * ----------------------------------------------------------------------------- */
+
+static void typemaps_changed(void) {
+  typemaps_generation++;
 }
 
 static String *typemap_method_name(const_String_or_char_ptr tmap_method) {
@@ -205,6 +239,7 @@ static void typemap_register(const_String_or_char_ptr tmap_method, ParmList *par
   }
 
   tm_method = typemap_method_name(tmap_method);
+  typemaps_changed();
 
   /* Register the first type in the parameter list */
 
@@ -414,6 +449,7 @@ void Swig_typemap_clear(const_String_or_char_ptr tmap_method, ParmList *parms) {
       Delattr(tm, "code");
       Delattr(tm, "locals");
       Delattr(tm, "kwargs");
+      typemaps_changed();
     }
   }
   Delete(multi_tmap_method);
@@ -604,6 +640,7 @@ void Swig_typemap_clear_apply(Parm *parms) {
 	  for (ki2 = First(h); ki2.key; ki2 = Next(ki2)) {
 	    Delattr(h, ki2.key);
 	  }
+	  typemaps_changed();
 	}
       }
     }
@@ -650,7 +687,7 @@ static Hash *typemap_search_helper(int debug_display, Hash *tm, const String *tm
     tm1 = Getattr(tm, cqualifiedname);
     if (tm1) {
       result = Getattr(tm1, tm_method);	/* See if there is a type - qualified name match */
-      if (result && Getattr(result, "code"))
+      if (result && Getattr(result, key_code))
 	goto ret_result;
       if (result)
 	*backup = result;
@@ -662,7 +699,7 @@ static Hash *typemap_search_helper(int debug_display, Hash *tm, const String *tm
     tm1 = Getattr(tm, cname);
     if (tm1) {
       result = Getattr(tm1, tm_method);	/* See if there is a type - name match */
-      if (result && Getattr(result, "code"))
+      if (result && Getattr(result, key_code))
 	goto ret_result;
       if (result)
 	*backup = result;
@@ -672,7 +709,7 @@ static Hash *typemap_search_helper(int debug_display, Hash *tm, const String *tm
     Printf(stdout, "  Looking for: %s\n", SwigType_str(ctype, 0));
   if (tm) {
     result = Getattr(tm, tm_method);	/* See if there is simply a type without name match */
-    if (result && Getattr(result, "code"))
+    if (result && Getattr(result, key_code))
       goto ret_result;
     if (result)
       *backup = result;
@@ -682,14 +719,14 @@ ret_result:
 }
 
 /* -----------------------------------------------------------------------------
- * typemap_search()
+ * typemap_search_uncached()
  *
  * Search for a typemap match. This is where the typemap pattern matching rules 
  * are implemented... tries to find the most specific typemap that includes a 
  * 'code' attribute.
  * ----------------------------------------------------------------------------- */
 
-static Hash *typemap_search(const_String_or_char_ptr tmap_method, SwigType *type, const_String_or_char_ptr name, const_String_or_char_ptr qualifiedname, SwigType **matchtype, Node *node) {
+static Hash *typemap_search_uncached(const_String_or_char_ptr tmap_method, SwigType *type, const_String_or_char_ptr name, const_String_or_char_ptr qualifiedname, SwigType **matchtype, Node *node) {
   Hash *result = 0;
   Hash *tm;
   Hash *backup = 0;
@@ -718,7 +755,7 @@ static Hash *typemap_search(const_String_or_char_ptr tmap_method, SwigType *type
     /* Try to get an exact type-match */
     tm = get_typemap(ctype);
     result = typemap_search_helper(debug_display, tm, tm_method, ctype, cqualifiedname, cname, &backup);
-    if (result && Getattr(result, "code"))
+    if (result && Getattr(result, key_code))
       goto ret_result;
 
     {
@@ -728,7 +765,7 @@ static Hash *typemap_search(const_String_or_char_ptr tmap_method, SwigType *type
 	tm = get_typemap(template_prefix);
 	result = typemap_search_helper(debug_display, tm, tm_method, template_prefix, cqualifiedname, cname, &backup);
 	Delete(template_prefix);
-	if (result && Getattr(result, "code"))
+	if (result && Getattr(result, key_code))
 	  goto ret_result;
       }
     }
@@ -742,7 +779,7 @@ static Hash *typemap_search(const_String_or_char_ptr tmap_method, SwigType *type
       tm = get_typemap(noarrays);
       result = typemap_search_helper(debug_display, tm, tm_method, noarrays, cqualifiedname, cname, &backup);
       Delete(noarrays);
-      if (result && Getattr(result, "code"))
+      if (result && Getattr(result, key_code))
 	goto ret_result;
     }
 
@@ -775,7 +812,7 @@ static Hash *typemap_search(const_String_or_char_ptr tmap_method, SwigType *type
   while (primitive) {
     tm = get_typemap(primitive);
     result = typemap_search_helper(debug_display, tm, tm_method, primitive, cqualifiedname, cname, &backup);
-    if (result && Getattr(result, "code"))
+    if (result && Getattr(result, key_code))
       goto ret_result;
 
     {
@@ -799,6 +836,86 @@ ret_result:
   return result;
 }
 
+/* -----------------------------------------------------------------------------
+ * typemap_search()
+ *
+ * Cached version of typemap_search_uncached().  The cache is keyed on the
+ * typemap method, type, name and qualified name.  With -debug-tmsearch the
+ * full search is always done so that it can be displayed, but the cache is
+ * still maintained in order to report the cache statistics.
+ * ----------------------------------------------------------------------------- */
+
+static Hash *typemap_search(const_String_or_char_ptr tmap_method, SwigType *type, const_String_or_char_ptr name, const_String_or_char_ptr qualifiedname, SwigType **matchtype, Node *node) {
+  Hash *result;
+  Hash *entry;
+  Hash *method_cache;
+  String *key;
+  String *tm_method = typemap_method_name(tmap_method);
+  int typesystem_generation = SwigType_typesystem_generation();
+  int symbol_generation = Swig_symbol_generation();
+  Symtab *scope = Swig_symbol_current();
+
+  if (!search_cache || search_cache_typemaps_generation != typemaps_generation || search_cache_typesystem_generation != typesystem_generation
+      || search_cache_symbol_generation != symbol_generation || search_cache_scope != scope) {
+    Delete(search_cache);
+    search_cache = NewHash();
+    search_cache_typemaps_generation = typemaps_generation;
+    search_cache_typesystem_generation = typesystem_generation;
+    search_cache_symbol_generation = symbol_generation;
+    search_cache_scope = scope;
+  }
+
+  method_cache = Getattr(search_cache, tm_method);
+  if (!method_cache) {
+    method_cache = NewHash();
+    Setattr(search_cache, tm_method, method_cache);
+    Delete(method_cache);
+  }
+  key = NewString(type);
+  if (name && Len(name)) {
+    Putc('\n', key);
+    Append(key, name);
+  }
+  if (qualifiedname && Len(qualifiedname)) {
+    Putc('\n', key);
+    Putc('\n', key);
+    Append(key, qualifiedname);
+  }
+
+  entry = Getattr(method_cache, key);
+  if (entry) {
+    search_cache_hits++;
+    if (!typemap_search_debug) {
+      Delete(key);
+      if (matchtype)
+	*matchtype = Copy(Getattr(entry, "matchtype"));
+      return Getattr(entry, "typemap");
+    }
+  } else {
+    search_cache_misses++;
+  }
+
+  {
+    SwigType *mtype = 0;
+    result = typemap_search_uncached(tmap_method, type, name, qualifiedname, &mtype, node);
+    if (!entry) {
+      entry = NewHash();
+      if (result)
+	Setattr(entry, "typemap", result);
+      if (mtype)
+	Setattr(entry, "matchtype", mtype);
+      Setattr(method_cache, key, entry);
+      Delete(entry);
+    }
+    if (matchtype)
+      *matchtype = mtype;
+    else
+      Delete(mtype);
+  }
+  Delete(key);
+  return result;
+}
+
 
 /* -----------------------------------------------------------------------------
  * typemap_search_multi()
@@ -2123,6 +2240,16 @@ void Swig_typemap_search_debug_set(void) {
   typemap_search_debug = 1;
 }
 
+/* -----------------------------------------------------------------------------
+ * Swig_typemap_search_debug_stats()
+ *
+ * Display the typemap search cache statistics
+ * ----------------------------------------------------------------------------- */
+
+void Swig_typemap_search_debug_stats(void) {
+  Printf(stdout, "Typemap search cache: %d hits, %d misses\n", search_cache_hits, search_cache_misses);
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_typemap_used_debug_set()
  *
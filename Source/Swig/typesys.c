@@ -158,6 +158,17 @@ static Hash *scopes = 0;	/* Hash table containing fully qualified scopes */
 static Hash *typedef_resolve_cache = 0;
 static Hash *typedef_all_cache = 0;
 static Hash *typedef_qualified_cache = 0;
+static List *typedef_cache_deps = 0;	/* Dependencies of the cache entry being computed */
+static String *symbols_dependency = 0;	/* Stands for the symbol tables in dependency lists */
+static String *symbols_version = 0;
+static int symbols_generation = 0;
+
+#define TYPEDEF_CACHE_RESOLVE   0
+#define TYPEDEF_CACHE_ALL       1
+#define TYPEDEF_CACHE_QUALIFIED 2
+static int typedef_cache_hits[3];
+static int typedef_cache_misses[3];
+static int typedef_cache_invalidations[3];
 
 static Typetab *SwigType_find_scope(Typetab *s, const SwigType *nameprefix);
 
@@ -180,10 +191,160 @@ int Swig_value_wrapper_mode(int mode) {
 }
 
 
-static void flush_cache() {
+/* -----------------------------------------------------------------------------
+ * Typedef resolution cache
+ *
+ * The results of SwigType_typedef_resolve(), SwigType_typedef_resolve_all() and
+ * SwigType_typedef_qualified() depend on the current scope, so a separate set
+ * of caches is kept for each type scope and changing scope merely selects
+ * another set.  While an entry is computed, every object consulted is recorded
+ * along with its version: the type scopes searched, the table of qualified
+ * scope names and, for some qualified types, the symbol tables.  An object's
+ * version is replaced whenever it is modified, which invalidates exactly the
+ * entries that looked at it.  Entries are checked when they are looked up.
+ * ----------------------------------------------------------------------------- */
+
+static int typesystem_generation = 0;
+
+static DOH *cache_version(DOH *obj) {
+  DOH *version;
+  if (obj == symbols_dependency) {
+    int generation = Swig_symbol_generation();
+    if (!symbols_version || generation != symbols_generation) {
+      Delete(symbols_version);
+      symbols_version = NewStringEmpty();
+      symbols_generation = generation;
+    }
+    return symbols_version;
+  }
+  version = Getmeta(obj, "cacheversion");
+  if (!version) {
+    version = NewStringEmpty();
+    Setmeta(obj, "cacheversion", version);
+    Delete(version);
+  }
+  return version;
+}
+
+static void cache_depends(DOH *obj, DOH *version) {
+  int i, len;
+  if (!typedef_cache_deps)
+    return;
+  len = Len(typedef_cache_deps);
+  for (i = 0; i < len; i += 2) {
+    if (Getitem(typedef_cache_deps, i) == obj)
+      return;
+  }
+  Append(typedef_cache_deps, obj);
+  Append(typedef_cache_deps, version ? version : cache_version(obj));
+}
+
+/* Record that the entry being computed depends on obj */
+static void cache_depend(DOH *obj) {
+  if (typedef_cache_deps)
+    cache_depends(obj, 0);
+}
+
+/* Returns the cache entry for t, or 0 if there is no valid entry */
+static Hash *cache_lookup(Hash *cache, const SwigType *t, int which) {
+  Hash *entry = Getattr(cache, t);
+  if (entry) {
+    List *deps = Getattr(entry, "deps");
+    int i, len = Len(deps);
+    for (i = 0; i < len; i += 2) {
+      if (cache_version(Getitem(deps, i)) != Getitem(deps, i + 1)) {
+	typedef_cache_invalidations[which]++;
+	Delattr(cache, t);
+	entry = 0;
+	break;
+      }
+    }
+    if (entry) {
+      typedef_cache_hits[which]++;
+      if (typedef_cache_deps) {
+	for (i = 0; i < len; i += 2)
+	  cache_depends(Getitem(deps, i), Getitem(deps, i + 1));
+      }
+      return entry;
+    }
+  }
+  typedef_cache_misses[which]++;
+  return 0;
+}
+
+/* Start computing a cache entry, returns the dependencies of the enclosing computation */
+static List *cache_begin(void) {
+  List *outer = typedef_cache_deps;
+  typedef_cache_deps = NewList();
+  return outer;
+}
+
+/* Store a cache entry for t, its dependencies are also added to the enclosing computation */
+static Hash *cache_end(Hash *cache, const SwigType *t, List *outer) {
+  Hash *entry = NewHash();
+  List *deps = typedef_cache_deps;
+  String *key = NewString(t);
+  int i, len = Len(deps);
+  Setattr(entry, "deps", deps);
+  Setattr(cache, key, entry);
+  typedef_cache_deps = outer;
+  if (outer) {
+    for (i = 0; i < len; i += 2)
+      cache_depends(Getitem(deps, i), Getitem(deps, i + 1));
+  }
+  Delete(key);
+  Delete(deps);
+  Delete(entry);
+  return entry;
+}
+
+/* Returns the named cache of the current scope */
+static Hash *scope_cache(const char *name) {
+  Hash *cache = Getmeta(current_scope, name);
+  if (!cache) {
+    cache = NewHash();
+    Setmeta(current_scope, name, cache);
+    Delete(cache);
+  }
+  return cache;
+}
+
+/* Invalidate cached results that consulted obj (0 if just the current scope changed) */
+static void flush_cache(DOH *obj) {
+  if (obj && Getmeta(obj, "cacheversion")) {
+    String *version = NewStringEmpty();
+    Setmeta(obj, "cacheversion", version);
+    Delete(version);
+  }
   typedef_resolve_cache = 0;
   typedef_all_cache = 0;
   typedef_qualified_cache = 0;
+  typesystem_generation++;
+}
+
+/* -----------------------------------------------------------------------------
+ * SwigType_typedef_cache_debug_stats()
+ *
+ * Print statistics on the use of the typedef resolution caches.
+ * ----------------------------------------------------------------------------- */
+
+void SwigType_typedef_cache_debug_stats(void) {
+  static const char *names[3] = { "resolve", "resolve_all", "qualified" };
+  int i;
+  for (i = 0; i < 3; i++) {
+    Printf(stdout, "Typedef %s cache: %d hits, %d misses, %d invalidated\n", names[i], typedef_cache_hits[i], typedef_cache_misses[i], typedef_cache_invalidations[i]);
+  }
+}
+
+/* -----------------------------------------------------------------------------
+ * SwigType_typesystem_generation()
+ *
+ * Returns a number that changes whenever typedefs or type scopes change, for
+ * use by caches of results that depend on typedef resolution.
+ * ----------------------------------------------------------------------------- */
+
+int SwigType_typesystem_generation(void) {
+  return typesystem_generation;
 }
 
 /* Initialize the scoping system */
@@ -204,6 +365,10 @@ void SwigType_typesystem_init() {
   current_symtab = 0;
   scopes = NewHash();
   Setattr(scopes, "", current_scope);
+
+  if (!symbols_dependency)
+    symbols_dependency = NewString("symbols");
+  flush_cache(0);
 }
 
 
@@ -234,7 +399,7 @@ int SwigType_typedef(const SwigType *type, const_String_or_char_ptr name) {
     }
   }
   Setattr(current_typetab, name, type);
-  flush_cache();
+  flush_cache(current_scope);
   return 0;
 }
 
@@ -254,7 +419,7 @@ int SwigType_typedef_class(const_String_or_char_ptr name) {
   Setmeta(cname, "class", "1");
   Setattr(current_typetab, cname, cname);
   Delete(cname);
-  flush_cache();
+  flush_cache(current_scope);
   return 0;
 }
 
@@ -323,7 +488,7 @@ void SwigType_new_scope(const_String_or_char_ptr name) {
   current_scope = s;
   current_typetab = ttab;
   current_symtab = 0;
-  flush_cache();
+  flush_cache(scopes);
 }
 
 /* -----------------------------------------------------------------------------
@@ -351,6 +516,7 @@ void SwigType_inherit_scope(Typetab *scope) {
       return;
   }
   Append(inherits, scope);
+  flush_cache(current_scope);
 }
 
 /* -----------------------------------------------------------------------------
@@ -368,7 +534,7 @@ void SwigType_scope_alias(String *aliasname, Typetab *ttab) {
   }
   Append(q, aliasname);
   Setattr(scopes, q, ttab);
-  flush_cache();
+  flush_cache(scopes);
 }
 
 /* -----------------------------------------------------------------------------
@@ -397,7 +563,7 @@ void SwigType_using_scope(Typetab *scope) {
     }
     Append(ulist, scope);
   }
-  flush_cache();
+  flush_cache(current_scope);
 }
 
 /* -----------------------------------------------------------------------------
@@ -415,7 +581,7 @@ Typetab *SwigType_pop_scope() {
   current_scope = t;
   current_typetab = Getattr(t, "typetab");
   current_symtab = Getattr(t, "symtab");
-  flush_cache();
+  flush_cache(0);
   return old;
 }
 
@@ -432,7 +598,7 @@ Typetab *SwigType_set_scope(Typetab *t) {
   current_scope = t;
   current_typetab = Getattr(t, "typetab");
   current_symtab = Getattr(t, "symtab");
-  flush_cache();
+  flush_cache(0);
   return old;
 }
 
@@ -445,6 +611,7 @@ Typetab *SwigType_set_scope(Typetab *t) {
 void SwigType_attach_symtab(Symtab *sym) {
   Setattr(current_scope, "symtab", sym);
   current_symtab = sym;
+  flush_cache(current_scope);
 }
 
 /* -----------------------------------------------------------------------------
@@ -489,6 +656,7 @@ static Typetab *SwigType_find_scope(Typetab *s, const SwigType *nameprefix) {
   if (Getmark(s))
     return 0;
   Setmark(s, 1);
+  cache_depend(scopes);
 
   is_template = SwigType_istemplate(nameprefix);
   if (is_template) {
@@ -522,6 +690,7 @@ static Typetab *SwigType_find_scope(Typetab *s, const SwigType *nameprefix) {
     if (!s) {
       /* Check inheritance */
       List *inherit;
+      cache_depend(ss);
       inherit = Getattr(ss, "using");
       if (inherit) {
 	Typetab *ttab;
@@ -575,6 +744,7 @@ static SwigType *_typedef_resolve(Typetab *s, String *base, int look_parent) {
 
   if (!Getmark(s)) {
     Setmark(s, 1);
+    cache_depend(s);
 
     ttab = Getattr(s, "typetab");
     type = Getattr(ttab, base);
@@ -689,18 +859,25 @@ SwigType *SwigType_typedef_resolve(const SwigType *t) {
   String *namebase = 0;
   String *nameprefix = 0, *rnameprefix = 0;
   int newtype = 0;
+#ifdef SWIG_TYPEDEF_RESOLVE_CACHE
+  List *outer_deps;
+#endif
 
   resolved_scope = 0;
 
 #ifdef SWIG_TYPEDEF_RESOLVE_CACHE
   if (!typedef_resolve_cache) {
-    typedef_resolve_cache = NewHash();
+    typedef_resolve_cache = scope_cache("typedefresolve");
   }
-  r = Getattr(typedef_resolve_cache, t);
-  if (r) {
-    resolved_scope = Getmeta(r, "scope");
-    return Copy(r);
+  {
+    Hash *entry = cache_lookup(typedef_resolve_cache, t, TYPEDEF_CACHE_RESOLVE);
+    if (entry) {
+      resolved_scope = Getattr(entry, "scope");
+      r = Getattr(entry, "result");
+      return r ? Copy(r) : 0;
+    }
   }
+  outer_deps = cache_begin();
 #endif
 
   base = SwigType_base(t);
@@ -719,6 +896,7 @@ SwigType *SwigType_typedef_resolve(const SwigType *t) {
       Delitem(base, 0);
     }
     /* Do a quick check in the local scope */
+    cache_depend(s);
     type = Getattr(ttab, base);
     if (type) {
       resolved_scope = s;
@@ -978,16 +1156,16 @@ SwigType *SwigType_typedef_resolve(const SwigType *t) {
 return_result:
 #ifdef SWIG_TYPEDEF_RESOLVE_CACHE
   {
-    String *key = NewString(t);
+    Hash *entry = cache_end(typedef_resolve_cache, t, outer_deps);
+    if (resolved_scope)
+      Setattr(entry, "scope", resolved_scope);
     if (r) {
       SwigType *r1;
-      Setattr(typedef_resolve_cache, key, r);
-      Setmeta(r, "scope", resolved_scope);
+      Setattr(entry, "result", r);
       r1 = Copy(r);
       Delete(r);
       r = r1;
     }
-    Delete(key);
   }
 #endif
   return r;
@@ -1002,16 +1180,19 @@ return_result:
 SwigType *SwigType_typedef_resolve_all(const SwigType *t) {
   SwigType *n;
   SwigType *r;
+  Hash *entry;
+  List *outer_deps;
   int count = 0;
 
   /* Check to see if the typedef resolve has been done before by checking the cache */
   if (!typedef_all_cache) {
-    typedef_all_cache = NewHash();
+    typedef_all_cache = scope_cache("typedefall");
   }
-  r = Getattr(typedef_all_cache, t);
-  if (r) {
-    return Copy(r);
+  entry = cache_lookup(typedef_all_cache, t, TYPEDEF_CACHE_ALL);
+  if (entry) {
+    return Copy(Getattr(entry, "result"));
   }
+  outer_deps = cache_begin();
 
 #ifdef SWIG_DEBUG
   Printf(stdout, "SwigType_typedef_resolve_all start ... %s\n", t);
@@ -1029,11 +1210,9 @@ SwigType *SwigType_typedef_resolve_all(const SwigType *t) {
 
   /* Add the typedef to the cache for next time it is looked up */
   {
-    String *key;
     SwigType *rr = Copy(r);
-    key = NewString(t);
-    Setattr(typedef_all_cache, key, rr);
-    Delete(key);
+    entry = cache_end(typedef_all_cache, t, outer_deps);
+    Setattr(entry, "result", rr);
     Delete(rr);
   }
 #ifdef SWIG_DEBUG
@@ -1064,15 +1243,18 @@ SwigType *SwigType_typedef_resolve_all(const SwigType *t) {
 SwigType *SwigType_typedef_qualified(const SwigType *t) {
   List *elements;
   String *result;
+  Hash *entry;
+  List *outer_deps;
   int i, len;
 
   if (!typedef_qualified_cache)
-    typedef_qualified_cache = NewHash();
-  result = Getattr(typedef_qualified_cache, t);
-  if (result) {
-    String *rc = Copy(result);
+    typedef_qualified_cache = scope_cache("typedefqualified");
+  entry = cache_lookup(typedef_qualified_cache, t, TYPEDEF_CACHE_QUALIFIED);
+  if (entry) {
+    String *rc = Copy(Getattr(entry, "result"));
     return rc;
   }
+  outer_deps = cache_begin();
 
   result = NewStringEmpty();
   elements = SwigType_split(t);
@@ -1139,6 +1321,8 @@ SwigType *SwigType_typedef_qualified(const SwigType *t) {
 	Iterator pi;
 	Parm *p;
 	List *parms;
+	cache_depend(current_scope);
+	cache_depend(symbols_dependency);
 	ty = Swig_symbol_template_deftype(e, current_symtab);
 	e = ty;
 	parms = SwigType_parmlist(e);
@@ -1230,6 +1414,7 @@ SwigType *SwigType_typedef_qualified(const SwigType *t) {
     } else if (SwigType_isarray(e)) {
       String *ndim;
       String *dim = SwigType_parm(e);
+      cache_depend(symbols_dependency);
       ndim = Swig_symbol_string_qualify(dim, 0);
       Printf(result, "a(%s).", ndim);
       Delete(dim);
@@ -1240,11 +1425,9 @@ SwigType *SwigType_typedef_qualified(const SwigType *t) {
   }
   Delete(elements);
   {
-    String *key, *cresult;
-    key = NewString(t);
-    cresult = NewString(result);
-    Setattr(typedef_qualified_cache, key, cresult);
-    Delete(key);
+    String *cresult = NewString(result);
+    entry = cache_end(typedef_qualified_cache, t, outer_deps);
+    Setattr(entry, "result", cresult);
     Delete(cresult);
   }
   return result;
@@ -2100,6 +2283,111 @@ List *SwigType_get_sorted_mangled_list() {
 }
 
 
+/* -----------------------------------------------------------------------------
+ * type_name_hash()
+ *
+ * Hash of a mangled type name, the same as SWIG_TypeNameHash() in the runtime
+ * (Lib/swigrun.swg).  Emitted in the type table so that SWIG_InitializeModule()
+ * does not need to compute it.
+ * ----------------------------------------------------------------------------- */
+
+static unsigned long type_name_hash(const char *c) {
+  unsigned long h = 5381;
+  for (; *c; ++c) {
+    if (*c != ' ')
+      h = ((h * 33) ^ (unsigned char) *c) & 0xffffffffUL;
+  }
+  return h;
+}
+
+/* -----------------------------------------------------------------------------
+ * SwigType_type_table_shared()
+ *
+ * Emit the type table with external linkage, suffixing its names with the given
+ * name, so that it can be shared by several translation units (split output).
+ * ----------------------------------------------------------------------------- */
+
+static String *type_table_shared = 0;
+
+void SwigType_type_table_shared(const_String_or_char_ptr name) {
+  Delete(type_table_shared);
+  type_table_shared = name ? NewString(name) : 0;
+}
+
+/* -----------------------------------------------------------------------------
+ * chained_hash_order()
+ *
+ * Returns the keys, given in the order they were added to a Hash, in the order
+ * the chained hash table Hash used to be iterated in.  The names of each type
+ * in the type table keep that order, as SWIG_TypePrettyName() uses the last one
+ * in the error messages of the wrappers.
+ * ----------------------------------------------------------------------------- */
+
+static List *chained_hash_order(List *keys) {
+  int nkeys = Len(keys);
+  int size = 7;
+  int *heads = (int *)malloc(size * sizeof(int));
+  int *next = (int *)malloc((nkeys + 1) * sizeof(int));
+  List *ordered = NewList();
+  int i, k;
+
+  for (i = 0; i < size; i++)
+    heads[i] = -1;
+  for (k = 0; k < nkeys; k++) {
+    /* Added at the end of its chain */
+    int *tail = &heads[Hashval(Getitem(keys, k)) % size];
+    while (*tail >= 0)
+      tail = &next[*tail];
+    *tail = k;
+    next[k] = -1;
+
+    if (k + 1 >= 2 * size) {
+      /* Resized, the chains are walked in order and their keys put at the start of the new chains */
+      int oldsize = size;
+      int *oldheads = heads;
+      int p = 3;
+      size = 2 * oldsize + 1;
+      while (p < (size >> 1)) {
+	if (((size / p) * p) == size) {
+	  size += 2;
+	  p = 3;
+	  continue;
+	}
+	p = p + 2;
+      }
+      heads = (int *)malloc(size * sizeof(int));
+      for (i = 0; i < size; i++)
+	heads[i] = -1;
+      for (i = 0; i < oldsize; i++) {
+	int n = oldheads[i];
+	while (n >= 0) {
+	  int hv = Hashval(Getitem(keys, n)) % size;
+	  int nextn = next[n];
+	  next[n] = heads[hv];
+	  heads[hv] = n;
+	  n = nextn;
+	}
+      }
+      free(oldheads);
+    }
+  }
+  for (i = 0; i < size; i++) {
+    for (k = heads[i]; k >= 0; k = next[k])
+      Append(ordered, Getitem(keys, k));
+  }
+  free(heads);
+  free(next);
+  return ordered;
+}
+
+/* Adds a name of a type in the type table, once */
+static void type_table_name(Hash *names, List *keys, String *name) {
+  if (!Getattr(names, name)) {
+    Setattr(names, name, "1");
+    Append(keys, name);
+  }
+}
+
 /* -----------------------------------------------------------------------------
  * SwigType_type_table()
  *
@@ -2168,6 +2456,7 @@ void SwigType_emit_type_table(File *f_forward, File *f_table) {
     Hash *lthash;
     Iterator ltiter;
     Hash *nthash;
+    List *ntkeys, *ntordered, *ltkeys, *ltordered;
 
     cast_temp = NewStringEmpty();
 
@@ -2183,46 +2472,47 @@ void SwigType_emit_type_table(File *f_forward, File *f_table) {
     lthash = Getattr(r_ltype, ki.item);
     nt = 0;
     nthash = NewHash();
-    ltiter = First(lthash);
-    while (ltiter.key) {
-      lt = ltiter.key;
+    ntkeys = NewList();
+    ltkeys = NewList();
+    for (ltiter = First(lthash); ltiter.key; ltiter = Next(ltiter))
+      Append(ltkeys, ltiter.key);
+    ltordered = chained_hash_order(ltkeys);
+    for (ei = First(ltordered); ei.item; ei = Next(ei)) {
+      lt = ei.item;
       rt = SwigType_typedef_resolve_all(lt);
       /* we save the original type and the fully resolved version */
       ln = SwigType_lstr(lt, 0);
       rn = SwigType_lstr(rt, 0);
-      if (Equal(ln, rn)) {
-        Setattr(nthash, ln, "1");
-      } else {
-	Setattr(nthash, rn, "1");
-	Setattr(nthash, ln, "1");
-      }
+      if (!Equal(ln, rn))
+	type_table_name(nthash, ntkeys, rn);
+      type_table_name(nthash, ntkeys, ln);
       if (SwigType_istemplate(rt)) {
         String *dt = Swig_symbol_template_deftype(rt, 0);
         String *dn = SwigType_lstr(dt, 0);
         if (!Equal(dn, rn) && !Equal(dn, ln)) {
-          Setattr(nthash, dn, "1");
+	  type_table_name(nthash, ntkeys, dn);
         }
         Delete(dt);
         Delete(dn);
       }
-
-      ltiter = Next(ltiter);
     }
+    Delete(ltordered);
+    Delete(ltkeys);
 
     /* now build nt */
-    ltiter = First(nthash);
-    nt = 0;
-    while (ltiter.key) {
+    ntordered = chained_hash_order(ntkeys);
+    for (ei = First(ntordered); ei.item; ei = Next(ei)) {
       if (nt) {
-	 Printf(nt, "|%s", ltiter.key);
+	 Printf(nt, "|%s", ei.item);
       } else {
-	 nt = NewString(ltiter.key);
+	 nt = NewString(ei.item);
       }
-      ltiter = Next(ltiter);
     }
+    Delete(ntordered);
+    Delete(ntkeys);
     Delete(nthash);
 
-    Printf(types, "\"%s\", \"%s\", 0, 0, (void*)%s, 0};\n", ki.item, nt, cd);
+    Printf(types, "\"%s\", \"%s\", 0, 0, (void*)%s, 0, 0x%08xUL, 0, 0};\n", ki.item, nt, cd, (unsigned int) type_name_hash(Char(ki.item)));
 
     el = SwigType_equivalent_mangle(ki.item, 0, 0);
     for (ei = First(el); ei.item; ei = Next(ei)) {
@@ -2238,7 +2528,7 @@ void SwigType_emit_type_table(File *f_forward, File *f_table) {
       Delete(ckey);
 
       if (!Getattr(r_mangled, ei.item) && !Getattr(imported_types, ei.item)) {
-	Printf(types, "static swig_type_info _swigt_%s = {\"%s\", 0, 0, 0, 0, 0};\n", ei.item, ei.item);
+	Printf(types, "static swig_type_info _swigt_%s = {\"%s\", 0, 0, 0, 0, 0, 0x%08xUL, 0, 0};\n", ei.item, ei.item, (unsigned int) type_name_hash(Char(ei.item)));
 	Append(table_list, ei.item);
 
 	Printf(cast, "static swig_cast_info _swigc_%s[] = {{&_swigt_%s, 0, 0, 0},{0, 0, 0, 0}};\n", ei.item, ei.item);
@@ -2279,8 +2569,21 @@ void SwigType_emit_type_table(File *f_forward, File *f_table) {
   Printf(f_table, "%s\n", cast_init);
   Printf(f_table, "\n/* -------- TYPE CONVERSION AND EQUIVALENCE RULES (END) -------- */\n\n");
 
-  Printf(f_forward, "static swig_type_info *swig_types[%d];\n", i + 1);
-  Printf(f_forward, "static swig_module_info swig_module = {swig_types, %d, 0, 0, 0, 0};\n", i);
+  if (type_table_shared) {
+    /* Defined once in the main file and declared extern in the shards, which define SWIG_SHARD */
+    Printf(f_forward, "#define swig_types swig_types_%s\n", type_table_shared);
+    Printf(f_forward, "#define swig_module swig_module_%s\n", type_table_shared);
+    Printf(f_forward, "#ifdef SWIG_SHARD\n");
+    Printf(f_forward, "extern swig_type_info *swig_types[%d];\n", i + 1);
+    Printf(f_forward, "extern swig_module_info swig_module;\n");
+    Printf(f_forward, "#else\n");
+    Printf(f_forward, "swig_type_info *swig_types[%d];\n", i + 1);
+    Printf(f_forward, "swig_module_info swig_module = {swig_types, %d, 0, 0, 0, 0, 0, 0};\n", i);
+    Printf(f_forward, "#endif\n");
+  } else {
+    Printf(f_forward, "static swig_type_info *swig_types[%d];\n", i + 1);
+    Printf(f_forward, "static swig_module_info swig_module = {swig_types, %d, 0, 0, 0, 0, 0, 0};\n", i);
+  }
   Printf(f_forward, "#define SWIG_TypeQuery(name) SWIG_TypeQueryModule(&swig_module, &swig_module, name)\n");
   Printf(f_forward, "#define SWIG_MangledTypeQuery(name) SWIG_MangledTypeQueryModule(&swig_module, &swig_module, name)\n");
   Printf(f_forward, "\n/* -------- TYPES TABLE (END) -------- */\n\n");
@@ -0,0 +1,37 @@
+# Checks that -cppcache gives the same output with a cold and a warm cache and
+# that a header changed between runs is preprocessed again.
+#
+# Usage: cmake -DSWIG=<swig> -DSWIG_INCLUDE=<dir> -DWORK=<dir> -P cppcache.cmake
+
+file (REMOVE_RECURSE ${WORK})
+file (MAKE_DIRECTORY ${WORK}/cache)
+file (WRITE ${WORK}/cppcache.i "%module cppcache\n%include \"value.h\"\n%constant int value = VALUE;\n")
+
+function (run_swig output)
+  execute_process (COMMAND ${SWIG} -I${SWIG_INCLUDE} -python -cppcache cache -o ${output} cppcache.i
+                   WORKING_DIRECTORY ${WORK} RESULT_VARIABLE result)
+  if (NOT result EQUAL 0)
+    message (FATAL_ERROR "swig failed writing ${output}")
+  endif ()
+endfunction ()
+
+file (WRITE ${WORK}/value.h "#define VALUE 1\n")
+run_swig (cold_wrap.c)
+file (GLOB entries ${WORK}/cache/*.swigpch)
+if (NOT entries)
+  message (FATAL_ERROR "nothing saved in the preprocessor cache")
+endif ()
+
+run_swig (warm_wrap.c)
+file (READ ${WORK}/cold_wrap.c cold)
+file (READ ${WORK}/warm_wrap.c warm)
+if (NOT cold STREQUAL warm)
+  message (FATAL_ERROR "output differs when using the preprocessor cache")
+endif ()
+
+file (WRITE ${WORK}/value.h "#define VALUE 22\n")
+run_swig (stale_wrap.c)
+file (READ ${WORK}/stale_wrap.c stale)
+if (NOT stale MATCHES "\"value\",SWIG_From_int\\(\\(int\\)\\(22\\)\\)")
+  message (FATAL_ERROR "changed header not preprocessed again")
+endif ()
@@ -0,0 +1,70 @@
+# Checks that -keepunchanged leaves the output files whose contents have not
+# changed untouched, that -changedfiles lists the files written and that an
+# output file that cannot be replaced fails the command.
+#
+# Usage: cmake -DSWIG=<swig> -DSWIG_INCLUDE=<dir> -DWORK=<dir> -P keepunchanged.cmake
+
+file (REMOVE_RECURSE ${WORK})
+file (MAKE_DIRECTORY ${WORK})
+
+function (run_swig expected_result)
+  execute_process (COMMAND ${SWIG} -I${SWIG_INCLUDE} -python -keepunchanged -changedfiles changed.txt keepunchanged.i
+                   WORKING_DIRECTORY ${WORK} RESULT_VARIABLE result ERROR_VARIABLE errors)
+  if (expected_result EQUAL 0 AND NOT result EQUAL 0)
+    message (FATAL_ERROR "swig failed: ${errors}")
+  elseif (NOT expected_result EQUAL 0 AND result EQUAL 0)
+    message (FATAL_ERROR "swig did not fail")
+  endif ()
+endfunction ()
+
+# Checks the files listed by -changedfiles and the files whose timestamps changed since the last check
+function (check_changed expected)
+  file (STRINGS ${WORK}/changed.txt changed)
+  list (SORT changed)
+  if (NOT "${changed}" STREQUAL "${expected}")
+    message (FATAL_ERROR "-changedfiles lists '${changed}' instead of '${expected}'")
+  endif ()
+  foreach (f keepunchanged_wrap.c keepunchanged.py)
+    file (TIMESTAMP ${WORK}/${f} timestamp "%s")
+    list (FIND expected ${f} index)
+    if (DEFINED last_${f} AND index EQUAL -1 AND NOT timestamp STREQUAL last_${f})
+      message (FATAL_ERROR "unchanged ${f} written")
+    elseif (DEFINED last_${f} AND NOT index EQUAL -1 AND timestamp STREQUAL last_${f})
+      message (FATAL_ERROR "changed ${f} not written")
+    endif ()
+    set (last_${f} ${timestamp} PARENT_SCOPE)
+  endforeach ()
+  file (GLOB leftovers ${WORK}/*.swigtmp)
+  if (leftovers)
+    message (FATAL_ERROR "temporary files left: ${leftovers}")
+  endif ()
+endfunction ()
+
+# Timestamps have a resolution of one second
+function (wait_timestamps)
+  execute_process (COMMAND ${CMAKE_COMMAND} -E sleep 1.1)
+endfunction ()
+
+file (WRITE ${WORK}/keepunchanged.i "%module keepunchanged\nint twice(int i);\n")
+run_swig (0)
+check_changed ("keepunchanged.py;keepunchanged_wrap.c")
+
+wait_timestamps ()
+run_swig (0)
+check_changed ("")
+
+wait_timestamps ()
+file (WRITE ${WORK}/keepunchanged.i "%module keepunchanged\n%{\n#define SWIG_CHANGED 1\n%}\nint twice(int i);\n")
+run_swig (0)
+check_changed ("keepunchanged_wrap.c")
+
+wait_timestamps ()
+file (APPEND ${WORK}/keepunchanged.i "int thrice(int i);\n")
+run_swig (0)
+check_changed ("keepunchanged.py;keepunchanged_wrap.c")
+
+# The module cannot replace a directory
+file (REMOVE ${WORK}/keepunchanged.py)
+file (MAKE_DIRECTORY ${WORK}/keepunchanged.py)
+file (WRITE ${WORK}/keepunchanged.py/keep "")
+run_swig (1)
@@ -0,0 +1,82 @@
+# Checks generating the wrappers for several target languages from one
+# command line with -multilang: the per language subdirectories, which options
+# each language gets, -o given among a language's own options replacing the one
+# given before the first language option, and the exit code when one language
+# fails.  Without -multilang the last target language option wins.
+#
+# Usage: cmake -DSWIG=<swig> -DSWIG_INCLUDE=<dir> -DWORK=<dir> -P multilang.cmake
+
+file (REMOVE_RECURSE ${WORK})
+file (MAKE_DIRECTORY ${WORK})
+file (WRITE ${WORK}/multilang.i "%module multilang\n%inline %{\nint twice(int i) { return 2*i; }\n%}\n")
+
+function (run_swig expected_result)
+  execute_process (COMMAND ${SWIG} -I${SWIG_INCLUDE} ${ARGN} multilang.i
+                   WORKING_DIRECTORY ${WORK} RESULT_VARIABLE result ERROR_VARIABLE errors)
+  if (expected_result EQUAL 0 AND NOT result EQUAL 0)
+    message (FATAL_ERROR "swig ${ARGN} failed: ${errors}")
+  elseif (NOT expected_result EQUAL 0 AND result EQUAL 0)
+    message (FATAL_ERROR "swig ${ARGN} did not fail")
+  endif ()
+endfunction ()
+
+function (check_files)
+  foreach (f ${ARGN})
+    if (NOT EXISTS ${WORK}/${f})
+      message (FATAL_ERROR "${f} not generated")
+    endif ()
+  endforeach ()
+endfunction ()
+
+# -builtin and -package are only valid for the language they follow
+run_swig (0 -multilang -python -builtin -java -package multipkg)
+check_files (python/multilang_wrap.c python/multilang.py java/multilang_wrap.c java/multilang.java java/multilangJNI.java)
+file (READ ${WORK}/java/multilangJNI.java jni)
+if (NOT jni MATCHES "package multipkg;")
+  message (FATAL_ERROR "-package not passed to java")
+endif ()
+file (READ ${WORK}/python/multilang_wrap.c python_wrapper)
+if (NOT python_wrapper MATCHES "SWIGPYTHON_BUILTIN")
+  message (FATAL_ERROR "-builtin not passed to python")
+endif ()
+
+# The options following a language option in SWIG_FEATURES only apply to that language
+file (REMOVE_RECURSE ${WORK}/python ${WORK}/java)
+set (ENV{SWIG_FEATURES} "-python -builtin")
+run_swig (0 -multilang -python -java)
+unset (ENV{SWIG_FEATURES})
+check_files (python/multilang_wrap.c java/multilang_wrap.c java/multilang.java)
+file (READ ${WORK}/python/multilang_wrap.c python_wrapper)
+if (NOT python_wrapper MATCHES "SWIGPYTHON_BUILTIN")
+  message (FATAL_ERROR "-builtin in SWIG_FEATURES not passed to python")
+endif ()
+
+# -o after -python replaces the -o given before it but not -outdir, java still uses its subdirectory
+file (REMOVE_RECURSE ${WORK}/python ${WORK}/java)
+file (MAKE_DIRECTORY ${WORK}/out)
+run_swig (0 -outdir out -o common_wrap.c -multilang -python -o own_wrap.c -java)
+check_files (own_wrap.c out/multilang.py java/common_wrap.c out/java/multilang.java)
+if (EXISTS ${WORK}/common_wrap.c OR EXISTS ${WORK}/python)
+  message (FATAL_ERROR "-o given before the first language used by python")
+endif ()
+
+# Without -multilang the last language option wins, as does a repeated one
+file (REMOVE_RECURSE ${WORK}/java ${WORK}/out)
+run_swig (0 -python -java)
+check_files (multilang_wrap.c multilang.java)
+if (EXISTS ${WORK}/python OR EXISTS ${WORK}/java OR EXISTS ${WORK}/multilang.py)
+  message (FATAL_ERROR "several languages generated without -multilang")
+endif ()
+file (REMOVE ${WORK}/multilang_wrap.c)
+set (ENV{SWIG_FEATURES} "-python -py3")
+run_swig (0 -python -c++)
+unset (ENV{SWIG_FEATURES})
+check_files (multilang_wrap.cxx multilang.py)
+if (EXISTS ${WORK}/python OR EXISTS ${WORK}/multilang_wrap.c)
+  message (FATAL_ERROR "a repeated language option generated several times")
+endif ()
+
+# A language failing fails the command, the other languages still run
+file (REMOVE_RECURSE ${WORK}/python ${WORK}/java)
+run_swig (1 -multilang -python -java -nosuchoption)
+check_files (python/multilang_wrap.c)
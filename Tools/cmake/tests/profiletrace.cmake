@@ -0,0 +1,55 @@
+# Checks that -profile-trace writes valid JSON in the Chrome trace event
+# format, with an event for each phase and for each class.
+#
+# Usage: cmake -DSWIG=<swig> -DSWIG_INCLUDE=<dir> -DWORK=<dir> -P profiletrace.cmake
+
+if (CMAKE_VERSION VERSION_LESS 3.19)
+  # string(JSON) is needed to check the trace
+  message (STATUS "Skipped, CMake 3.19 or later is needed")
+  return ()
+endif ()
+
+file (REMOVE_RECURSE ${WORK})
+file (MAKE_DIRECTORY ${WORK})
+file (WRITE ${WORK}/profiletrace.i "%module profiletrace\n%include \"profile trace.h\"\n")
+file (WRITE ${WORK}/profile\ trace.h "class Shape { public: virtual ~Shape(); };\nclass Circle : public Shape {};\n")
+
+execute_process (COMMAND ${SWIG} -I${SWIG_INCLUDE} -c++ -python -profile -profile-trace trace.json profiletrace.i
+                 WORKING_DIRECTORY ${WORK} RESULT_VARIABLE result OUTPUT_VARIABLE report ERROR_VARIABLE errors)
+if (NOT result EQUAL 0)
+  message (FATAL_ERROR "swig failed: ${errors}")
+endif ()
+if (NOT report MATCHES "Profile \\(wall time")
+  message (FATAL_ERROR "no -profile report: ${report}")
+endif ()
+
+file (READ ${WORK}/trace.json trace)
+string (JSON count ERROR_VARIABLE error LENGTH "${trace}" traceEvents)
+if (error)
+  message (FATAL_ERROR "invalid JSON in trace.json: ${error}")
+endif ()
+
+set (names)
+math (EXPR last "${count} - 1")
+foreach (i RANGE ${last})
+  foreach (key name cat ph ts dur)
+    string (JSON ${key} ERROR_VARIABLE error GET "${trace}" traceEvents ${i} ${key})
+    if (error)
+      message (FATAL_ERROR "event ${i} has no ${key}: ${error}")
+    endif ()
+  endforeach ()
+  if (NOT ph STREQUAL "X" OR NOT ts MATCHES "^[0-9]+$" OR NOT dur MATCHES "^[0-9]+$")
+    message (FATAL_ERROR "invalid event ${i}: ${ph} ${ts} ${dur}")
+  endif ()
+  list (APPEND names "${cat}:${name}")
+endforeach ()
+
+foreach (expected phase:preprocess phase:parse phase:typepass phase:allocate phase:generate class:Shape class:Circle)
+  list (FIND names ${expected} index)
+  if (index EQUAL -1)
+    message (FATAL_ERROR "no ${expected} event in ${names}")
+  endif ()
+endforeach ()
+if (NOT names MATCHES "include:[^;]*profile trace.h")
+  message (FATAL_ERROR "no event for including profile trace.h in ${names}")
+endif ()
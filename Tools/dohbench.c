@@ -0,0 +1,170 @@
+/* -----------------------------------------------------------------------------
+ * This file is part of SWIG, which is licensed as a whole under version 3
+ * (or any later version) of the GNU General Public License. Some additional
+ * terms also apply to certain portions of SWIG. The full details of the SWIG
+ * license and copyrights can be found in the LICENSE and COPYRIGHT files
+ * included with the SWIG source code as distributed by the SWIG developers
+ * and at https://www.swig.org/legal.html.
+ *
+ * dohbench.c
+ *
+ * Micro-benchmark of DOH Hash node-attribute churn.  Replays the attribute
+ * names of every node of a real parse tree, as recorded by dohbench.py from
+ * the -xmlout output of an interface file, against the DOH library it is
+ * linked with.  Not built as part of SWIG, see Tools/dohbench.py.
+ *
+ * Usage: dohbench tracefile [rounds]
+ * ----------------------------------------------------------------------------- */
+
+#include "doh.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+  int nkeys;
+  char **keys;
+} TraceNode;
+
+static TraceNode *nodes = 0;
+static int nnodes = 0;
+
+/* -----------------------------------------------------------------------------
+ * read_trace()
+ *
+ * One node per line, attribute names separated by tabs.
+ * ----------------------------------------------------------------------------- */
+
+static void read_trace(FILE *f) {
+  static char line[65536];
+  int maxnodes = 1024;
+  nodes = (TraceNode *) malloc(maxnodes * sizeof(TraceNode));
+  while (fgets(line, sizeof(line), f)) {
+    TraceNode *t;
+    char *s;
+    int maxkeys = 8;
+    line[strcspn(line, "\r\n")] = 0;
+    if (nnodes == maxnodes) {
+      maxnodes *= 2;
+      nodes = (TraceNode *) realloc(nodes, maxnodes * sizeof(TraceNode));
+    }
+    t = &nodes[nnodes++];
+    t->nkeys = 0;
+    t->keys = (char **) malloc(maxkeys * sizeof(char *));
+    for (s = strtok(line, "\t"); s; s = strtok(0, "\t")) {
+      if (t->nkeys == maxkeys) {
+	maxkeys *= 2;
+	t->keys = (char **) realloc(t->keys, maxkeys * sizeof(char *));
+      }
+      t->keys[t->nkeys++] = strdup(s);
+    }
+  }
+}
+
+static double elapsed(clock_t start) {
+  return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char **argv) {
+  FILE *f;
+  DOH **hashes;
+  DOH *value;
+  int rounds = 20;
+  int r, i, k;
+  long found = 0;
+  clock_t start;
+
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s tracefile [rounds]\n", argv[0]);
+    return 1;
+  }
+  if (argc > 2)
+    rounds = atoi(argv[2]);
+  f = fopen(argv[1], "r");
+  if (!f) {
+    fprintf(stderr, "Unable to open %s\n", argv[1]);
+    return 1;
+  }
+  read_trace(f);
+  fclose(f);
+  hashes = (DOH **) malloc(nnodes * sizeof(DOH *));
+  value = NewString("value");
+
+  /* Create the nodes, as the parser does */
+  start = clock();
+  for (r = 0; r < rounds; r++) {
+    for (i = 0; i < nnodes; i++) {
+      DOH *h = NewHash();
+      for (k = 0; k < nodes[i].nkeys; k++)
+	Setattr(h, nodes[i].keys[k], value);
+      hashes[i] = h;
+    }
+    if (r + 1 < rounds) {
+      for (i = 0; i < nnodes; i++)
+	Delete(hashes[i]);
+    }
+  }
+  printf("build %.4f\n", elapsed(start));
+
+  /* Look up every attribute a node has */
+  start = clock();
+  for (r = 0; r < rounds; r++) {
+    for (i = 0; i < nnodes; i++) {
+      for (k = 0; k < nodes[i].nkeys; k++)
+	found += Getattr(hashes[i], nodes[i].keys[k]) != 0;
+    }
+  }
+  printf("lookup %.4f\n", elapsed(start));
+
+  /* Probe for attributes a node may not have, eg features */
+  start = clock();
+  for (r = 0; r < rounds; r++) {
+    for (i = 0; i < nnodes; i++) {
+      TraceNode *t = &nodes[(i + 1) % nnodes];
+      for (k = 0; k < t->nkeys; k++)
+	found += Getattr(hashes[i], t->keys[k]) != 0;
+    }
+  }
+  printf("probe %.4f\n", elapsed(start));
+
+  /* Add and remove temporary attributes, as the language modules do */
+  start = clock();
+  for (r = 0; r < rounds; r++) {
+    for (i = 0; i < nnodes; i++) {
+      TraceNode *t = &nodes[(i + 1) % nnodes];
+      for (k = 0; k < t->nkeys; k++)
+	Setattr(hashes[i], t->keys[k], value);
+      for (k = 0; k < t->nkeys; k++)
+	Delattr(hashes[i], t->keys[k]);
+      for (k = 0; k < nodes[i].nkeys; k++)
+	Setattr(hashes[i], nodes[i].keys[k], value);
+    }
+  }
+  printf("update %.4f\n", elapsed(start));
+
+  /* Iterate over the attributes */
+  start = clock();
+  for (r = 0; r < rounds; r++) {
+    for (i = 0; i < nnodes; i++) {
+      Iterator ki;
+      for (ki = First(hashes[i]); ki.key; ki = Next(ki))
+	found++;
+    }
+  }
+  printf("iterate %.4f\n", elapsed(start));
+
+  /* Copy the nodes, as the template instantiation does */
+  start = clock();
+  for (r = 0; r < rounds; r++) {
+    for (i = 0; i < nnodes; i++)
+      Delete(Copy(hashes[i]));
+  }
+  printf("copy %.4f\n", elapsed(start));
+
+  for (i = 0; i < nnodes; i++)
+    Delete(hashes[i]);
+  Delete(value);
+  printf("nodes %d found %ld\n", nnodes, found);
+  return 0;
+}
@@ -0,0 +1,131 @@
+#!/usr/bin/env python
+
+# Micro-benchmark of DOH Hash node-attribute churn on a real interface file.
+#
+# The attribute names of every node in the parse tree of the interface are
+# recorded from swig's -xmlout output.  Tools/dohbench.c replays them (node
+# creation, lookups, probes for missing attributes, temporary attributes being
+# added and removed, iteration and copying) and is built twice: once against
+# the DOH sources of a baseline git revision and once against the DOH sources
+# in the working tree.  For example, to compare with the master branch:
+#
+#   python Tools/dohbench.py --swig build/swig --config build/Source/Include master
+#
+# By default the parse tree of Examples/test-suite/li_std_containers_int.i,
+# which pulls in most of the Python STL support library, is used.  Another
+# interface file and swig options can be given after '--':
+#
+#   python Tools/dohbench.py master -- -c++ -python -Ipath big.i
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import xml.etree.ElementTree as ET
+
+import argparse
+parser = argparse.ArgumentParser(description="Compare DOH Hash node-attribute churn")
+parser.add_argument("baseline", help="git revision with the baseline DOH sources")
+parser.add_argument("--swig", default="swig", help="swig executable used to record the parse tree [swig]")
+parser.add_argument("--config", help="directory containing swigconfig.h [Source/Include]")
+parser.add_argument("--cc", default=os.environ.get("CC", "cc"), help="C compiler [$CC or cc]")
+parser.add_argument("-n", "--runs", type=int, default=5, help="number of timed runs of each build [5]")
+parser.add_argument("-r", "--rounds", type=int, default=20, help="number of passes over the parse tree in each run [20]")
+parser.add_argument("swigargs", nargs=argparse.REMAINDER, help="arguments passed to swig, after --")
+args = parser.parse_args()
+
+# Tools directory path $ENV/swig/Tools
+toolsdir = os.path.dirname(os.path.abspath(__file__))
+# Root directory path (swig) $ENV/swig
+rootdir = os.path.abspath(os.path.join(toolsdir, os.pardir))
+
+swigargs = args.swigargs
+if swigargs and swigargs[0] == "--":
+    swigargs = swigargs[1:]
+if not swigargs:
+    swigargs = ["-c++", "-python", os.path.join(rootdir, "Examples", "test-suite", "li_std_containers_int.i")]
+config = args.config or os.path.join(rootdir, "Source", "Include")
+if not os.path.exists(os.path.join(config, "swigconfig.h")):
+    parser.error("swigconfig.h not found in {}, use --config".format(config))
+
+env = dict(os.environ)
+if "SWIG_LIB" not in env:
+    env["SWIG_LIB"] = os.path.join(rootdir, "Lib")
+
+def run(cmd, **kwargs):
+    p = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, **kwargs)
+    output = p.communicate()[0].decode("utf-8", "replace")
+    if p.returncode != 0:
+        sys.stdout.write(output)
+        print("'{}' failed with exit code {}".format(" ".join(cmd), p.returncode))
+        sys.exit(2)
+    return output
+
+def record_trace(workdir):
+    """Write the attribute names of each parse tree node, one node per line"""
+    xmlfile = os.path.join(workdir, "tree.xml")
+    run([args.swig, "-xmlout", xmlfile, "-outdir", workdir, "-o", os.path.join(workdir, "bench_wrap.cxx")] + swigargs, env=env)
+    tracefile = os.path.join(workdir, "trace.txt")
+    with open(tracefile, "w") as f:
+        for event, elem in ET.iterparse(xmlfile):
+            if elem.tag == "attributelist":
+                names = [a.get("name") for a in elem if a.tag == "attribute"]
+                f.write("\t".join(names) + "\n")
+                elem.clear()
+    return tracefile
+
+def build(name, dohdir, workdir):
+    exe = os.path.join(workdir, name)
+    sources = sorted(os.path.join(dohdir, f) for f in os.listdir(dohdir) if f.endswith(".c"))
+    run([args.cc, "-O2", "-I" + dohdir, "-I" + config, "-o", exe, os.path.join(toolsdir, "dohbench.c")] + sources)
+    return exe
+
+def median(values):
+    values = sorted(values)
+    n = len(values)
+    return values[n // 2] if n % 2 else (values[n // 2 - 1] + values[n // 2]) / 2.0
+
+workdir = tempfile.mkdtemp(prefix="dohbench")
+try:
+    tracefile = record_trace(workdir)
+    basedir = os.path.join(workdir, "baseline")
+    os.mkdir(basedir)
+    archive = subprocess.Popen(["git", "-C", rootdir, "archive", args.baseline, "Source/DOH"], stdout=subprocess.PIPE)
+    run(["tar", "-x", "-C", basedir], stdin=archive.stdout)
+    archive.stdout.close()
+    if archive.wait() != 0:
+        print("Unable to extract Source/DOH at revision {}".format(args.baseline))
+        sys.exit(2)
+    exes = (("baseline", build("dohbench-baseline", os.path.join(basedir, "Source", "DOH"), workdir)),
+            ("candidate", build("dohbench-candidate", os.path.join(rootdir, "Source", "DOH"), workdir)))
+
+    times = {}
+    nodes = None
+    # Interleave the runs so that any drift in machine load affects both equally
+    for i in range(args.runs):
+        for label, exe in exes:
+            for line in run([exe, tracefile, str(args.rounds)]).splitlines():
+                fields = line.split()
+                if fields[0] == "nodes":
+                    if nodes is not None and nodes != fields:
+                        print("Inconsistent results: {} and {}".format(" ".join(nodes), " ".join(fields)))
+                        sys.exit(2)
+                    nodes = fields
+                else:
+                    times.setdefault((label, fields[0]), []).append(float(fields[1]))
+finally:
+    shutil.rmtree(workdir)
+
+print("{} parse tree nodes, {} rounds, median of {} runs".format(nodes[1], args.rounds, args.runs))
+print("{:10} {:>10} {:>10} {:>8}".format("phase", "baseline", "candidate", "speedup"))
+phases = [phase for (label, phase) in times if label == "baseline"]
+for phase in phases + ["total"]:
+    if phase == "total":
+        base = sum(median(times[("baseline", p)]) for p in phases)
+        cand = sum(median(times[("candidate", p)]) for p in phases)
+    else:
+        base = median(times[("baseline", phase)])
+        cand = median(times[("candidate", phase)])
+    speedup = "{:.2f}x".format(base / cand) if cand > 0 else "-"
+    print("{:10} {:9.3f}s {:9.3f}s {:>8}".format(phase, base, cand, speedup))